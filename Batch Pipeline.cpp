@@ -0,0 +1,99 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+#include "Batch Pipeline.h"
+#include "Bounded Queue.h"
+#include "Instrumentation.h"
+
+// +-------------------------------------------< BATCH PIPELINE >-------------------------------------------+
+
+struct BatchBuffer
+{
+    size_t frameIndex;
+    bool   succeeded;
+    int    current;
+    Image  images[2];
+};
+
+std::vector<size_t> RunBatchPipeline(const std::vector<BatchFrame>& frames, const std::vector<BatchOperation>& operations, size_t bufferCount)
+{
+    TraceScope trace("RunBatchPipeline", "pipeline");
+
+    bufferCount = std::max<size_t>(bufferCount, 1);
+
+    // Every queue can hold the whole pool, so returning a buffer never blocks and only an empty free queue throttles the reader
+    std::vector<BatchBuffer>   buffers(bufferCount);
+    BoundedQueue<BatchBuffer*> freeBuffers(bufferCount);
+    BoundedQueue<BatchBuffer*> readBuffers(bufferCount);
+    BoundedQueue<BatchBuffer*> computedBuffers(bufferCount);
+    std::vector<size_t>        failedFrames;
+
+    for (BatchBuffer& buffer : buffers)
+        freeBuffers.Push(&buffer);
+
+    std::thread reader([&] {
+        BatchBuffer* buffer;
+
+        for (size_t frameIndex = 0; frameIndex < frames.size() && freeBuffers.Pop(buffer); ++frameIndex)
+        {
+            const BatchFrame& frame = frames[frameIndex];
+            TraceScope        trace("ReadFrame", "pipeline");
+
+            buffer->frameIndex = frameIndex;
+            buffer->current    = 0;
+            buffer->succeeded  = ReadRawImage(frame.inputFileName.c_str(), buffer->images[0], frame.width, frame.height);
+
+            readBuffers.Push(buffer);
+        }
+        readBuffers.Close();
+    });
+
+    std::thread writer([&] {
+        BatchBuffer* buffer;
+
+        while (computedBuffers.Pop(buffer))
+        {
+            const BatchFrame& frame = frames[buffer->frameIndex];
+            TraceScope        trace("WriteFrame", "pipeline");
+
+            if (!buffer->succeeded || !WriteRawImage(frame.outputFileName.c_str(), buffer->images[buffer->current]))
+                failedFrames.push_back(buffer->frameIndex);
+
+            freeBuffers.Push(buffer);
+        }
+    });
+
+    BatchBuffer* buffer;
+
+    // The operations ping-pong between the two images of a buffer, each one reading the result of the one before
+    while (readBuffers.Pop(buffer))
+    {
+        TraceScope trace("ComputeFrame", "pipeline");
+
+        if (buffer->succeeded)
+            for (const BatchOperation& operation : operations)
+            {
+                operation(buffer->images[buffer->current], buffer->images[1 - buffer->current]);
+                buffer->current = 1 - buffer->current;
+            }
+
+        computedBuffers.Push(buffer);
+    }
+    computedBuffers.Close();
+
+    writer.join();
+    reader.join();
+
+    return failedFrames;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
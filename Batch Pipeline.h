@@ -0,0 +1,37 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+
+// +-------------------------------------------< BATCH PIPELINE >-------------------------------------------+
+
+// One step of a batch pipeline. outputImage is a different buffer than inputImage and is resized by the operation.
+typedef std::function<void(const Image& inputImage, Image& outputImage)> BatchOperation;
+
+struct BatchFrame
+{
+    std::string inputFileName;
+    std::string outputFileName;
+    size_t      width;
+    size_t      height;
+};
+
+// Runs every frame through the operations in order and writes the result, overlapping the stages across frames: a reader thread
+// loads the next frames while the calling thread computes and a writer thread stores the finished ones. Frames travel in a pool of
+// bufferCount reusable image pairs, which bounds the memory in flight and makes the slowest stage set the pace, so once the
+// pipeline is full the I/O hides behind the computation. The operations run on the calling thread only, one frame at a time, and
+// may keep scratch state between calls. Returns the indices of the frames that could not be read or written, in frame order.
+std::vector<size_t> RunBatchPipeline(const std::vector<BatchFrame>& frames, const std::vector<BatchOperation>& operations, size_t bufferCount = 4);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
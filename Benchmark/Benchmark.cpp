@@ -0,0 +1,543 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+#include "Image Processing.h"
+
+// +--------------------------------------------< OPERATION >-----------------------------------------------+
+
+// One benchmarked call. run returns the number of bytes the call read and wrote, which turns the latency into a bandwidth.
+struct Operation
+{
+    const char* name;
+    bool        windowed;
+    int         slowWindow;
+    int         maximumWindow;
+
+    std::function<size_t(const Image&, Image&, int)> run;
+};
+
+static size_t ImageBytes(const Image& image)
+{
+    return image.Width() * image.Height();
+}
+
+static std::vector<Operation> CreateOperations(void)
+{
+    std::vector<Operation> operations;
+
+    // The brute-force filters cost O(wsize^2) or O(wsize log wsize) per pixel, so windows above slowWindow are skipped unless asked for
+    operations.push_back({ "AveragingBlur", true, 15, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        AveragingBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "SeparableAveragingBlur", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        SeparableAveragingBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "CreateIntegralImage", false, 0, 0, [](const Image& inputImage, Image&, int) {
+        static thread_local IntegralImage integralImage;
+
+        CreateIntegralImage(inputImage, integralImage);
+        return ImageBytes(inputImage) + integralImage.Width() * integralImage.Height() * sizeof(lbyte_t);
+    } });
+    operations.push_back({ "IntegralAveragingBlur", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        static thread_local IntegralImage integralImage;
+
+        CreateIntegralImage(inputImage, integralImage);
+        IntegralAveragingBlur(inputImage, integralImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "SeparableMedianBlur", true, 31, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        SeparableMedianBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "SeparableHistogramMedianBlur", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        SeparableHistogramMedianBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "AdaptiveMedianBlur", true, 65535, 255, [](const Image& inputImage, Image& outputImage, int wsize) {
+        static thread_local Image noisyImage;
+
+        // Five percent impulses, the same ones on every run; creating them is part of the measured time, being cheap next to the filter
+        CreateSaltAndPepperNoise(inputImage, noisyImage, 0.05F, 1);
+        AdaptiveMedianBlur(noisyImage, outputImage, std::max(wsize, 3));
+        return 2 * ImageBytes(inputImage) + 2 * ImageBytes(outputImage);
+    } });
+    operations.push_back({ "HistogramMedianBlur", true, 65535, 255, [](const Image& inputImage, Image& outputImage, int wsize) {
+        HistogramMedianBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "UnsharpMasking", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        static thread_local IntegralImage integralImage;
+        static thread_local Image         blurImage;
+
+        CreateIntegralImage(inputImage, integralImage);
+        IntegralAveragingBlur(inputImage, integralImage, blurImage, wsize);
+        UnsharpMasking(inputImage, blurImage, outputImage);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "SlidingAveragingBlur", true, 65535, 4103, [](const Image& inputImage, Image& outputImage, int wsize) {
+        SlidingAveragingBlur(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "StreamingUnsharpMasking", true, 65535, 4103, [](const Image& inputImage, Image& outputImage, int wsize) {
+        StreamingUnsharpMasking(inputImage, outputImage, wsize);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    // The window size stands for six standard deviations, the extent that holds nearly all of the Gaussian
+    operations.push_back({ "GaussianBlur", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        GaussianBlur(inputImage, outputImage, wsize / 6.0F);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "GaussianUnsharpMasking", true, 65535, 65535, [](const Image& inputImage, Image& outputImage, int wsize) {
+        GaussianUnsharpMasking(inputImage, outputImage, wsize / 6.0F);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    // A dense wsize x wsize kernel of fixed pseudo-random weights, which only DIRECT and FFT can take
+    operations.push_back({ "Convolution", true, 65535, 255, [](const Image& inputImage, Image& outputImage, int wsize) {
+        std::mt19937       random(static_cast<uint32_t>(wsize));
+        std::vector<float> weights(static_cast<size_t>(wsize) * wsize);
+
+        for (float& weight : weights)
+            weight = (static_cast<float>(random() % 2001) / 1000.0F - 1.0F) / weights.size();
+
+        Convolve(inputImage, outputImage, ConvolutionKernel(wsize, wsize, weights.data(), 128.0F));
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "GaussianConvolution", true, 65535, 255, [](const Image& inputImage, Image& outputImage, int wsize) {
+        Convolve(inputImage, outputImage, ConvolutionKernel::Gaussian(wsize / 6.0F));
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "HistogramEqualization", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        HistogramEqualization(inputImage, outputImage);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "ContrastLimitedEqualization", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        ContrastLimitedEqualization(inputImage, outputImage);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "HistogramSpecification", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        HistogramSpecification(inputImage, outputImage);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "ZeroOrderInterpolator", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        ZeroOrderInterpolator(inputImage, outputImage, 2);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "FirstOrderInterpolator", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        FirstOrderInterpolator(inputImage, outputImage);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+    operations.push_back({ "Resample", false, 0, 0, [](const Image& inputImage, Image& outputImage, int) {
+        Resample(inputImage, outputImage, 2 * inputImage.Width(), 2 * inputImage.Height(), ResamplingFilter::BICUBIC);
+        return ImageBytes(inputImage) + ImageBytes(outputImage);
+    } });
+
+    return operations;
+}
+
+// +---------------------------------------------< SETTINGS >-----------------------------------------------+
+
+struct ImageSize
+{
+    size_t width;
+    size_t height;
+};
+
+struct Settings
+{
+    std::vector<ImageSize>   sizes;
+    std::vector<int>         windows;
+    std::vector<std::string> operations;
+    int                      repetitions;
+    int                      warmup;
+    double                   timeLimit;
+    size_t                   threadCount;
+    std::string              cpus;
+    std::string              format;
+    std::string              outputFileName;
+    bool                     allWindows;
+};
+
+static const char* USAGE =
+    "usage: Benchmark [options]\n"
+    "  --sizes LIST        image sizes, N for N x N, WxH, 4K or 8K (default 256,512,1024,2048,4096,8K)\n"
+    "  --windows LIST      odd window sizes of the windowed filters (default 3,7,15,31,63)\n"
+    "  --operations LIST   operations to run (default all, --list prints them)\n"
+    "  --repetitions N     measured runs per case (default 15)\n"
+    "  --warmup N          unmeasured runs before measuring (default 2)\n"
+    "  --time-limit S      stop measuring a case after S seconds, keeping at least one run (default 10)\n"
+    "  --threads N         worker threads, 0 for one per hardware thread (default 0)\n"
+    "  --cpus LIST         pin the process to these CPUs, e.g. 0-3,8 (Linux only)\n"
+    "  --all-windows       also run brute-force filters on windows beyond their usual range\n"
+    "  --format FORMAT     text, csv or json (default text)\n"
+    "  --output FILE       write the report to FILE instead of stdout\n";
+
+static std::vector<std::string> SplitList(const char* text)
+{
+    std::vector<std::string> items;
+    std::string              item;
+
+    for (const char* character = text; ; ++character)
+    {
+        if (*character == ',' || *character == '\0')
+        {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+
+            if (*character == '\0')
+                break;
+        }
+        else
+            item += *character;
+    }
+
+    return items;
+}
+
+static bool ParseImageSize(const std::string& text, ImageSize& size)
+{
+    if (text == "4K")
+        size = { 3840, 2160 };
+    else if (text == "8K")
+        size = { 7680, 4320 };
+    else
+    {
+        unsigned long width, height;
+        char          separator;
+        int           consumed = 0;
+
+        if (sscanf(text.c_str(), "%lu%c%lu%n", &width, &separator, &height, &consumed) == 3 && (separator == 'x' || separator == 'X') && consumed == static_cast<int>(text.size()))
+            size = { width, height };
+        else if (sscanf(text.c_str(), "%lu%n", &width, &consumed) == 1 && consumed == static_cast<int>(text.size()))
+            size = { width, width };
+        else
+            return false;
+    }
+
+    return size.width > 0 && size.height > 0;
+}
+
+static bool ParseSettings(int argc, char** argv, Settings& settings, const std::vector<Operation>& operations)
+{
+    settings.repetitions = 15;
+    settings.warmup      = 2;
+    settings.timeLimit   = 10.0;
+    settings.threadCount = 0;
+    settings.format      = "text";
+    settings.allWindows  = false;
+
+    const char* sizes   = "256,512,1024,2048,4096,8K";
+    const char* windows = "3,7,15,31,63";
+
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string option = argv[index];
+        const char*       value  = (index + 1 < argc) ? (argv[index + 1]) : (NULL);
+
+        if (option == "--list")
+        {
+            for (const Operation& operation : operations)
+                printf("%s\n", operation.name);
+
+            exit(0);
+        }
+        else if (option == "--all-windows")
+        {
+            settings.allWindows = true;
+            continue;
+        }
+        else if (value == NULL)
+            return false;
+
+        if (option == "--sizes")
+            sizes = value;
+        else if (option == "--windows")
+            windows = value;
+        else if (option == "--operations")
+            settings.operations = SplitList(value);
+        else if (option == "--repetitions")
+            settings.repetitions = atoi(value);
+        else if (option == "--warmup")
+            settings.warmup = atoi(value);
+        else if (option == "--time-limit")
+            settings.timeLimit = atof(value);
+        else if (option == "--threads")
+            settings.threadCount = static_cast<size_t>(atol(value));
+        else if (option == "--cpus")
+            settings.cpus = value;
+        else if (option == "--format")
+            settings.format = value;
+        else if (option == "--output")
+            settings.outputFileName = value;
+        else
+            return false;
+
+        ++index;
+    }
+
+    for (const std::string& item : SplitList(sizes))
+    {
+        ImageSize size;
+
+        if (!ParseImageSize(item, size))
+            return false;
+        settings.sizes.push_back(size);
+    }
+
+    for (const std::string& item : SplitList(windows))
+    {
+        const int wsize = atoi(item.c_str());
+
+        if (wsize <= 0 || wsize % 2 == 0)
+            return false;
+        settings.windows.push_back(wsize);
+    }
+
+    for (const std::string& name : settings.operations)
+        if (std::none_of(operations.begin(), operations.end(), [&](const Operation& operation) { return name == operation.name; }))
+            return false;
+
+    return settings.repetitions > 0 && settings.warmup >= 0 && settings.timeLimit > 0.0 && !settings.sizes.empty() && !settings.windows.empty() &&
+           (settings.format == "text" || settings.format == "csv" || settings.format == "json");
+}
+
+// +-------------------------------------------< CPU PINNING >----------------------------------------------+
+
+// Must run before the first operation, so the worker threads the pool spawns inherit the mask
+static bool PinToCPUs(const std::string& cpus)
+{
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+    for (const std::string& item : SplitList(cpus.c_str()))
+    {
+        int first, last;
+
+        if (sscanf(item.c_str(), "%d-%d", &first, &last) != 2)
+            first = last = atoi(item.c_str());
+        if (first < 0 || last < first || last >= CPU_SETSIZE)
+            return false;
+
+        for (int cpu = first; cpu <= last; ++cpu)
+            CPU_SET(cpu, &cpuSet);
+    }
+
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    (void)cpus;
+
+    return false;
+#endif
+}
+
+// +----------------------------------------------< RESULT >------------------------------------------------+
+
+struct Result
+{
+    std::string operation;
+    ImageSize   size;
+    int         wsize;
+    int         repetitions;
+    double      medianMs;
+    double      p99Ms;
+    double      minimumMs;
+    double      meanMs;
+    double      megapixelsPerSecond;
+    double      bytesPerSecond;
+};
+
+static Result Measure(const Operation& operation, const Image& inputImage, int wsize, const Settings& settings)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Image               outputImage;
+    std::vector<double> elapsedMs;
+    size_t              bytes = 0;
+
+    for (int run = 0; run < settings.warmup; ++run)
+        operation.run(inputImage, outputImage, wsize);
+
+    const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.timeLimit));
+
+    for (int run = 0; run < settings.repetitions && (run == 0 || Clock::now() < deadline); ++run)
+    {
+        const Clock::time_point startTime = Clock::now();
+
+        bytes = operation.run(inputImage, outputImage, wsize);
+        elapsedMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - startTime).count());
+    }
+
+    std::sort(elapsedMs.begin(), elapsedMs.end());
+
+    Result result;
+
+    result.operation   = operation.name;
+    result.size        = { inputImage.Width(), inputImage.Height() };
+    result.wsize       = wsize;
+    result.repetitions = static_cast<int>(elapsedMs.size());
+    result.medianMs    = (elapsedMs.size() % 2 == 1) ? (elapsedMs[elapsedMs.size() / 2]) : ((elapsedMs[elapsedMs.size() / 2 - 1] + elapsedMs[elapsedMs.size() / 2]) / 2.0);
+    result.p99Ms       = elapsedMs[std::min(elapsedMs.size() - 1, static_cast<size_t>(0.99 * elapsedMs.size()))];
+    result.minimumMs   = elapsedMs.front();
+    result.meanMs      = 0.0;
+
+    for (double elapsed : elapsedMs)
+        result.meanMs += elapsed / elapsedMs.size();
+
+    result.megapixelsPerSecond = inputImage.Width() * inputImage.Height() / (result.medianMs * 1000.0);
+    result.bytesPerSecond      = bytes / (result.medianMs / 1000.0);
+
+    return result;
+}
+
+// +----------------------------------------------< REPORT >------------------------------------------------+
+
+static const char* SIMDLevelName(SIMDLevel simdLevel)
+{
+    switch (simdLevel)
+    {
+    case SIMDLevel::AVX2:
+        return "avx2";
+    case SIMDLevel::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+static void PrintResult(FILE* fileStream, const Settings& settings, const Result& result, bool first)
+{
+    if (settings.format == "csv")
+    {
+        if (first)
+            fprintf(fileStream, "operation,width,height,window,repetitions,median_ms,p99_ms,min_ms,mean_ms,megapixels_per_second,bytes_per_second\n");
+
+        fprintf(fileStream, "%s,%zu,%zu,%d,%d,%.6f,%.6f,%.6f,%.6f,%.3f,%.0f\n", result.operation.c_str(), result.size.width, result.size.height, result.wsize, result.repetitions,
+                result.medianMs, result.p99Ms, result.minimumMs, result.meanMs, result.megapixelsPerSecond, result.bytesPerSecond);
+    }
+    else if (settings.format == "json")
+    {
+        fprintf(fileStream, "%s\n    { \"operation\": \"%s\", \"width\": %zu, \"height\": %zu, \"window\": %d, \"repetitions\": %d, \"median_ms\": %.6f, \"p99_ms\": %.6f, "
+                "\"min_ms\": %.6f, \"mean_ms\": %.6f, \"megapixels_per_second\": %.3f, \"bytes_per_second\": %.0f }",
+                (first) ? ("") : (","), result.operation.c_str(), result.size.width, result.size.height, result.wsize, result.repetitions, result.medianMs, result.p99Ms,
+                result.minimumMs, result.meanMs, result.megapixelsPerSecond, result.bytesPerSecond);
+    }
+    else
+    {
+        if (first)
+            fprintf(fileStream, "%-30s %11s %6s %11s %11s %11s %11s\n", "operation", "size", "window", "median ms", "p99 ms", "MP/s", "GB/s");
+
+        char size[32];
+
+        snprintf(size, sizeof(size), "%zux%zu", result.size.width, result.size.height);
+        fprintf(fileStream, "%-30s %11s %6d %11.3f %11.3f %11.1f %11.2f\n", result.operation.c_str(), size, result.wsize, result.medianMs, result.p99Ms, result.megapixelsPerSecond,
+                result.bytesPerSecond / 1e9);
+    }
+
+    fflush(fileStream);
+}
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    const std::vector<Operation> operations = CreateOperations();
+    Settings                     settings;
+
+    if (!ParseSettings(argc, argv, settings, operations))
+    {
+        fputs(USAGE, stderr);
+
+        return 2;
+    }
+
+    if (!settings.cpus.empty() && !PinToCPUs(settings.cpus))
+    {
+        fprintf(stderr, "cannot pin to CPUs %s\n", settings.cpus.c_str());
+
+        return 1;
+    }
+
+    SetThreadCount(settings.threadCount);
+
+    FILE* fileStream = (settings.outputFileName.empty()) ? (stdout) : (fopen(settings.outputFileName.c_str(), "w"));
+
+    if (fileStream == NULL)
+    {
+        fprintf(stderr, "cannot write %s\n", settings.outputFileName.c_str());
+
+        return 1;
+    }
+
+    if (settings.format == "json")
+        fprintf(fileStream, "{\n  \"threads\": %zu,\n  \"simd\": \"%s\",\n  \"warmup\": %d,\n  \"results\": [", GetThreadCount(), SIMDLevelName(GetSIMDLevel()), settings.warmup);
+    else if (settings.format == "text")
+        fprintf(fileStream, "threads %zu, simd %s, warm-up %d, repetitions %d\n", GetThreadCount(), SIMDLevelName(GetSIMDLevel()), settings.warmup, settings.repetitions);
+
+    std::mt19937 generator(0x1234567);
+    bool         first = true;
+
+    for (const ImageSize& size : settings.sizes)
+    {
+        // A fixed seed keeps the input, and with it the data-dependent median and histogram costs, identical between versions
+        Image inputImage(size.width, size.height);
+
+        for (size_t iy = 0; iy < size.height; ++iy)
+            for (size_t ix = 0; ix < size.width; ++ix)
+                inputImage(ix, iy) = static_cast<byte_t>(generator());
+
+        for (const Operation& operation : operations)
+        {
+            if (!settings.operations.empty() && std::find(settings.operations.begin(), settings.operations.end(), operation.name) == settings.operations.end())
+                continue;
+
+            if (!operation.windowed)
+            {
+                PrintResult(fileStream, settings, Measure(operation, inputImage, 0, settings), first);
+                first = false;
+
+                continue;
+            }
+
+            for (int wsize : settings.windows)
+            {
+                if (wsize > operation.maximumWindow || (wsize > operation.slowWindow && !settings.allWindows))
+                    continue;
+
+                PrintResult(fileStream, settings, Measure(operation, inputImage, wsize, settings), first);
+                first = false;
+            }
+        }
+    }
+
+    if (settings.format == "json")
+        fprintf(fileStream, "\n  ]\n}\n");
+
+    if (fileStream != stdout)
+        fclose(fileStream);
+
+    return 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,109 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "Border Mode.h"
+#include "Image Pool.h"
+
+// +--------------------------------------------< BORDER MODE >---------------------------------------------+
+
+template <typename Pixel>
+ImageBuffer<Pixel>& CreateBorderImage(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& borderImage, ptrdiff_t columnBegin, ptrdiff_t columnEnd,
+                                      ptrdiff_t rowBegin, ptrdiff_t rowEnd, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    assert(columnBegin <= columnEnd && rowBegin <= rowEnd);
+    assert(!inputImage.IsEmpty());
+
+    const ptrdiff_t width  = inputImage.Width();
+    const ptrdiff_t height = inputImage.Height();
+
+    // The columns inside the image are one contiguous copy per row, only the ones outside go through BorderIndex
+    const ptrdiff_t insideBegin = std::min(std::max<ptrdiff_t>(columnBegin, 0), width);
+    const ptrdiff_t insideEnd   = std::max(std::min(columnEnd, width), insideBegin);
+
+    std::vector<ptrdiff_t> sourceColumns(columnEnd - columnBegin);
+    Pixel                  borderPixel;
+
+    std::fill_n(reinterpret_cast<PixelSample<Pixel>*>(&borderPixel), PixelTraits<Pixel>::CHANNELS, borderValue);
+
+    for (ptrdiff_t ix = columnBegin; ix < columnEnd; ++ix)
+        sourceColumns[ix - columnBegin] = BorderIndex(ix, width, border);
+
+    borderImage.Resize(columnEnd - columnBegin, rowEnd - rowBegin);
+
+    for (ptrdiff_t iy = rowBegin; iy < rowEnd; ++iy)
+    {
+        const ptrdiff_t sourceRow = BorderIndex(iy, height, border);
+        Pixel*          borderRow = borderImage.Row(iy - rowBegin);
+
+        if (sourceRow < 0)
+        {
+            std::fill_n(borderRow, columnEnd - columnBegin, borderPixel);
+            continue;
+        }
+
+        const Pixel* inputRow = inputImage.Row(sourceRow);
+
+        for (ptrdiff_t ix = columnBegin; ix < insideBegin; ++ix)
+            borderRow[ix - columnBegin] = (sourceColumns[ix - columnBegin] < 0) ? (borderPixel) : (inputRow[sourceColumns[ix - columnBegin]]);
+        memcpy(borderRow + (insideBegin - columnBegin), inputRow + insideBegin, (insideEnd - insideBegin) * sizeof(Pixel));
+        for (ptrdiff_t ix = insideEnd; ix < columnEnd; ++ix)
+            borderRow[ix - columnBegin] = (sourceColumns[ix - columnBegin] < 0) ? (borderPixel) : (inputRow[sourceColumns[ix - columnBegin]]);
+    }
+
+    return borderImage;
+}
+
+template Image&     CreateBorderImage(const Image&, Image&, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, BorderMode, byte_t);
+template WideImage& CreateBorderImage(const WideImage&, WideImage&, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, BorderMode, wbyte_t);
+template RGBImage&  CreateBorderImage(const RGBImage&, RGBImage&, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, BorderMode, byte_t);
+template RGBAImage& CreateBorderImage(const RGBAImage&, RGBAImage&, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, BorderMode, byte_t);
+
+template <typename Pixel>
+ImageBuffer<Pixel>& FilterBorder(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, int radius, BorderMode border, PixelSample<Pixel> borderValue,
+                                 const typename BorderFilter<Pixel>::Function& filter)
+{
+    if (border == BorderMode::NONE || radius == 0 || inputImage.IsEmpty())
+        return outputImage;
+
+    const ptrdiff_t width  = inputImage.Width();
+    const ptrdiff_t height = inputImage.Height();
+
+    ScratchImage<Pixel> borderImage;
+    ScratchImage<Pixel> filteredImage;
+
+    // Pads columns columnBegin ... columnEnd - 1 and rows rowBegin ... rowEnd - 1, filters them and copies the output rectangle
+    // back. Every output pixel lies at least radius pixels inside the padded strip, so its whole window is in there.
+    const auto filterStrip = [&](ptrdiff_t columnBegin, ptrdiff_t columnEnd, ptrdiff_t rowBegin, ptrdiff_t rowEnd,
+                                 ptrdiff_t outputColumnBegin, ptrdiff_t outputColumnEnd, ptrdiff_t outputRowBegin, ptrdiff_t outputRowEnd) {
+        if (outputColumnBegin >= outputColumnEnd || outputRowBegin >= outputRowEnd)
+            return;
+
+        // Sized up front so neither the padding nor the filter allocates outside the pool
+        borderImage.Resize(columnEnd - columnBegin, rowEnd - rowBegin);
+        filteredImage.Resize(columnEnd - columnBegin, rowEnd - rowBegin);
+        filter(CreateBorderImage(inputImage, borderImage, columnBegin, columnEnd, rowBegin, rowEnd, border, borderValue), filteredImage);
+
+        for (ptrdiff_t iy = outputRowBegin; iy < outputRowEnd; ++iy)
+            memcpy(outputImage.Row(iy) + outputColumnBegin, filteredImage.Row(iy - rowBegin) + (outputColumnBegin - columnBegin),
+                   (outputColumnEnd - outputColumnBegin) * sizeof(Pixel));
+    };
+
+    // Top and bottom strips span the full width, the left and right ones the rows in between. On images narrower or lower than
+    // two radii the strips simply cover everything, the interior being empty.
+    filterStrip(-radius, width + radius, -radius, 2 * radius, 0, width, 0, std::min<ptrdiff_t>(radius, height));
+    filterStrip(-radius, width + radius, height - 2 * radius, height + radius, 0, width, std::max<ptrdiff_t>(height - radius, radius), height);
+    filterStrip(-radius, 2 * radius, 0, height, 0, std::min<ptrdiff_t>(radius, width), radius, height - radius);
+    filterStrip(width - 2 * radius, width + radius, 0, height, std::max<ptrdiff_t>(width - radius, radius), width, radius, height - radius);
+
+    return outputImage;
+}
+
+template Image&     FilterBorder(const Image&, Image&, int, BorderMode, byte_t, const BorderFilter<byte_t>::Function&);
+template WideImage& FilterBorder(const WideImage&, WideImage&, int, BorderMode, wbyte_t, const BorderFilter<wbyte_t>::Function&);
+template RGBImage&  FilterBorder(const RGBImage&, RGBImage&, int, BorderMode, byte_t, const BorderFilter<RGBPixel>::Function&);
+template RGBAImage& FilterBorder(const RGBAImage&, RGBAImage&, int, BorderMode, byte_t, const BorderFilter<RGBAPixel>::Function&);
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
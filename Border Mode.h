@@ -0,0 +1,74 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef BORDER_MODE_H
+#define BORDER_MODE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+#include <functional>
+
+#include "Image.h"
+
+// +--------------------------------------------< BORDER MODE >---------------------------------------------+
+
+// How a windowed filter sees the pixels its windows reach beyond the image, shown for a row abcd
+enum class BorderMode : uint8_t
+{
+    NONE      = 0,  // no outside pixels: the wsize / 2 rows and columns along the border stay copies of the input
+    REPLICATE = 1,  // aaa|abcd|ddd
+    REFLECT   = 2,  // cba|abcd|dcb with the edge pixel repeated
+    WRAP      = 3,  // bcd|abcd|abc
+    CONSTANT  = 4   // kkk|abcd|kkk for a given border value k
+};
+
+// The pixel an index outside 0 ... length - 1 stands for, or -1 for a CONSTANT border. Windows larger than the image keep
+// reflecting or wrapping, so every index maps inside.
+inline ptrdiff_t BorderIndex(ptrdiff_t index, ptrdiff_t length, BorderMode border)
+{
+    assert(length > 0);
+    assert(border != BorderMode::NONE);
+
+    if (index >= 0 && index < length)
+        return index;
+
+    switch (border)
+    {
+    case BorderMode::REPLICATE:
+        return (index < 0) ? (0) : (length - 1);
+    case BorderMode::REFLECT:
+        index = ((index % (2 * length)) + 2 * length) % (2 * length);
+        return (index < length) ? (index) : (2 * length - 1 - index);
+    case BorderMode::WRAP:
+        return ((index % length) + length) % length;
+    default:
+        return -1;
+    }
+}
+
+// Copies columns columnBegin ... columnEnd - 1 and rows rowBegin ... rowEnd - 1 of inputImage, which may reach beyond it, into
+// borderImage as seen through border. A constant border sets every channel to borderValue.
+template <typename Pixel>
+ImageBuffer<Pixel>& CreateBorderImage(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& borderImage, ptrdiff_t columnBegin, ptrdiff_t columnEnd,
+                                      ptrdiff_t rowBegin, ptrdiff_t rowEnd, BorderMode border, PixelSample<Pixel> borderValue = 0);
+
+// The NONE variant of a windowed filter, as FilterBorder runs it on the padded strips. Spelled out as a member type so the pixel
+// format is deduced from the images alone and a lambda can be passed.
+template <typename Pixel>
+struct BorderFilter
+{
+    typedef std::function<void(const ImageBuffer<Pixel>&, ImageBuffer<Pixel>&)> Function;
+};
+
+// Fills the radius-wide frame of outputImage that a windowed filter leaves unfiltered under NONE. filter, the NONE variant of that
+// filter, runs on border-padded copies of the four edge strips only, so the interior keeps its branch-free loops, nothing but the
+// strips is ever padded and the frame comes out as if the whole image had been padded, filtered and cropped.
+template <typename Pixel>
+ImageBuffer<Pixel>& FilterBorder(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, int radius, BorderMode border, PixelSample<Pixel> borderValue,
+                                 const typename BorderFilter<Pixel>::Function& filter);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
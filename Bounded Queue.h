@@ -0,0 +1,84 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// +-------------------------------------------< BOUNDED QUEUE >--------------------------------------------+
+
+// A first-in first-out hand-over between threads holding at most capacity items. Push blocks while the queue is full and Pop while
+// it is empty, so a fast producer is throttled to the pace of its consumer instead of piling up work. Close wakes everybody up:
+// pushes fail from then on, and pops drain what is left before they fail.
+template <typename Item>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity(capacity), closed(false)
+    {
+        assert(capacity > 0);
+    }
+
+    bool Push(Item item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+
+        if (closed)
+            return false;
+
+        items.push_back(std::move(item));
+        lock.unlock();
+        notEmpty.notify_one();
+
+        return true;
+    }
+
+    bool Pop(Item& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+
+        if (items.empty())
+            return false;
+
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+
+        return true;
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    const size_t            capacity;
+    bool                    closed;
+    std::deque<Item>        items;
+    std::mutex              mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
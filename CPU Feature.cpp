@@ -0,0 +1,60 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <atomic>
+
+#include "CPU Feature.h"
+
+// +--------------------------------------------< CPU FEATURE >---------------------------------------------+
+
+SIMDLevel DetectSIMDLevel(void)
+{
+#if defined(SIMD_X86) && defined(_MSC_VER)
+    int cpuInfo[4];
+
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] >= 7)
+    {
+        __cpuid(cpuInfo, 1);
+        const bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+        const bool avx     = (cpuInfo[2] & (1 << 28)) != 0;
+
+        __cpuidex(cpuInfo, 7, 0);
+        if (osxsave && avx && (cpuInfo[1] & (1 << 5)) != 0 && (_xgetbv(0) & 0x6) == 0x6)
+            return SIMDLevel::AVX2;
+    }
+
+    return SIMDLevel::SSE2;
+#elif defined(SIMD_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return SIMDLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SIMDLevel::SSE2;
+
+    return SIMDLevel::SCALAR;
+#else
+    return SIMDLevel::SCALAR;
+#endif
+}
+
+static std::atomic<SIMDLevel>& GetSIMDLevelInstance(void)
+{
+    static std::atomic<SIMDLevel> simdLevel(DetectSIMDLevel());
+
+    return simdLevel;
+}
+
+SIMDLevel GetSIMDLevel(void)
+{
+    return GetSIMDLevelInstance().load(std::memory_order_relaxed);
+}
+
+void SetSIMDLevel(SIMDLevel simdLevel)
+{
+    const SIMDLevel detectedLevel = DetectSIMDLevel();
+
+    GetSIMDLevelInstance().store((simdLevel < detectedLevel) ? (simdLevel) : (detectedLevel), std::memory_order_relaxed);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
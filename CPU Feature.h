@@ -0,0 +1,50 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef CPU_FEATURE_H
+#define CPU_FEATURE_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define SIMD_X86 1
+#endif
+
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+    #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SIMD_TARGET_SSE2
+    #define SIMD_TARGET_AVX2
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cinttypes>
+
+#if defined(SIMD_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+
+    #include <immintrin.h>
+#endif
+
+// +---------------------------------------------< SIMD LEVEL >---------------------------------------------+
+
+enum class SIMDLevel : uint8_t
+{
+    SCALAR = 0,
+    SSE2   = 1,
+    AVX2   = 2
+};
+
+// +--------------------------------------------< CPU FEATURE >---------------------------------------------+
+
+SIMDLevel DetectSIMDLevel(void);
+
+SIMDLevel GetSIMDLevel(void);
+
+// Caps the kernels at simdLevel, e.g. SIMDLevel::SCALAR to compare against the reference path. Levels the CPU lacks are ignored.
+void SetSIMDLevel(SIMDLevel simdLevel);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
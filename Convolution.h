@@ -0,0 +1,92 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "Border Mode.h"
+#include "Image.h"
+
+// +-----------------------------------------< CONVOLUTION KERNEL >-----------------------------------------+
+
+// A width x height grid of weights, both odd, row by row with the centre weight at (width / 2, height / 2). Every weight multiplies
+// the pixel under it as the grid is laid on the image, without mirroring it first, so tables such as Sobel's read as written.
+// offset is added to every result before clipping, e.g. 128 to keep the negative half of a derivative visible in an unsigned image.
+// The constructor finds the largest singular value of the grid and its singular vectors; when they reproduce every weight the
+// kernel is separable and also kept as one column of weights times one row of weights.
+class ConvolutionKernel
+{
+public:
+    ConvolutionKernel(size_t width, size_t height, const float* weights, float offset = 0.0F);
+
+    // wsize x wsize weights of 1 / wsize^2, the window of AveragingBlur
+    static ConvolutionKernel Box(int wsize);
+
+    // The Gaussian sampled out to 3 sigma on either side and normalized to a sum of 1
+    static ConvolutionKernel Gaussian(float sigma);
+
+    // The central difference along the rows, or down the columns if vertical, smoothed by 1 2 1 across it
+    static ConvolutionKernel Sobel(bool vertical = false, float offset = 0.0F);
+
+    // The sum of the four neighbours minus four times the centre
+    static ConvolutionKernel Laplacian(float offset = 0.0F);
+
+    // 3 x 3 unsharp masking: the centre plus lambda times its difference from the 3 x 3 mean
+    static ConvolutionKernel Sharpening(float lambda = 0.3F);
+
+    size_t Width() const;
+
+    size_t Height() const;
+
+    float Weight(size_t ix, size_t iy) const;
+
+    float Offset() const;
+
+    bool IsSeparable() const;
+
+    // Of a separable kernel, Weight(ix, iy) = ColumnWeights()[iy] * RowWeights()[ix] up to rounding
+    const std::vector<float>& RowWeights() const;
+
+    const std::vector<float>& ColumnWeights() const;
+
+private:
+    size_t             width;
+    size_t             height;
+    std::vector<float> weights;
+    float              offset;
+    std::vector<float> rowWeights;
+    std::vector<float> columnWeights;
+};
+
+// +--------------------------------------------< CONVOLUTION >---------------------------------------------+
+
+enum class ConvolutionMethod : uint8_t
+{
+    AUTOMATIC = 0, // the cheapest of the ones below for the kernel, the image size and the pixel format
+    DIRECT    = 1, // every weight at every pixel; 8-bit samples take 16-bit fixed-point weights, wider ones single precision
+    SEPARABLE = 2, // a pass along the rows and one down the columns, for separable kernels only; others run DIRECT
+    FFT       = 3  // products of Fourier transforms of image tiles, in single precision
+};
+
+// The method AUTOMATIC takes for the kernel on a width x height image of Pixel: the least of the modelled costs per output sample,
+// DIRECT per nonzero weight, SEPARABLE per row and column weight, FFT per transformed tile sample at the tile size that wastes the
+// least on overlap. 8-bit DIRECT is priced at the current SIMD level.
+template <typename Pixel>
+ConvolutionMethod SelectConvolutionMethod(const ConvolutionKernel& kernel, size_t width, size_t height);
+
+// Convolves every channel with kernel, rounding the result plus the offset to the nearest sample value and clipping it to the
+// sample range. Like the other windowed filters it leaves a frame of Width() / 2 columns and Height() / 2 rows unfiltered under
+// NONE, and filters it through padded edge strips under any other border, so the methods only ever see whole windows. All methods
+// agree within one sample value.
+template <typename Pixel>
+ImageBuffer<Pixel>& Convolve(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const ConvolutionKernel& kernel,
+                             BorderMode border = BorderMode::REPLICATE, PixelSample<Pixel> borderValue = 0, ConvolutionMethod method = ConvolutionMethod::AUTOMATIC);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,174 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef FIXED_POINT_KERNEL_H
+#define FIXED_POINT_KERNEL_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+
+#include "CPU Feature.h"
+
+// +------------------------------------------< FIXED POINT ROW >-------------------------------------------+
+
+// Samples begin ... end - 1 of one output row of an 8-bit convolution in fixed point: output[i] = (bias + the sum over the taps of
+// weight[t] * sources[t][i]) >> shift, clipped to 0 ... 255. The 16-bit weights come in pairs, weightPairs[p] holding weight 2p in
+// its low and weight 2p + 1 in its high half, so the vector paths feed two taps to every multiply-add; an odd tap count ends with a
+// zero weight whose source repeats the last one. The caller keeps bias plus any sum within 32 bits.
+inline void FixedPointConvolutionRowScalar(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t begin, size_t end,
+                                           int32_t bias, int shift)
+{
+    static const size_t CHUNK = 32;
+
+    // A chunk of sums at a time and a tap at a time across it, so short rows such as the edge strips pay little per tap
+    for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += CHUNK)
+    {
+        const size_t count = (end - chunkBegin < CHUNK) ? (end - chunkBegin) : (CHUNK);
+        int32_t      sums[CHUNK];
+
+        for (size_t index = 0; index < count; ++index)
+            sums[index] = bias;
+
+        for (size_t pair = 0; pair < pairs; ++pair)
+        {
+            const int32_t  firstWeight  = static_cast<int16_t>(weightPairs[pair] & 0xFFFF);
+            const int32_t  secondWeight = static_cast<int16_t>(weightPairs[pair] >> 16);
+            const uint8_t* first        = sources[2 * pair] + chunkBegin;
+            const uint8_t* second       = sources[2 * pair + 1] + chunkBegin;
+
+            for (size_t index = 0; index < count; ++index)
+                sums[index] += firstWeight * first[index] + secondWeight * second[index];
+        }
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            const int32_t sum = sums[index] >> shift;
+
+            output[chunkBegin + index] = static_cast<uint8_t>((sum < 0) ? (0) : ((sum > 255) ? (255) : (sum)));
+        }
+    }
+}
+
+#if defined(SIMD_X86)
+
+// Sixteen samples from ix on: the samples of a tap pair are interleaved into 16-bit pairs, which _mm_madd_epi16 multiplies by the
+// weight pair and adds up in one 32-bit lane. The saturating packs do the clipping and leave the samples in order.
+SIMD_TARGET_SSE2 inline void FixedPointConvolutionStepSSE2(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t ix,
+                                                           __m128i biases, __m128i shiftCount)
+{
+    const __m128i zero    = _mm_setzero_si128();
+    __m128i       sums[4] = { biases, biases, biases, biases };
+
+    for (size_t pair = 0; pair < pairs; ++pair)
+    {
+        const __m128i weights = _mm_set1_epi32(static_cast<int>(weightPairs[pair]));
+        const __m128i first   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[2 * pair] + ix));
+        const __m128i second  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[2 * pair + 1] + ix));
+        const __m128i low     = _mm_unpacklo_epi8(first, second);
+        const __m128i high    = _mm_unpackhi_epi8(first, second);
+
+        sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi8(low, zero), weights));
+        sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi8(low, zero), weights));
+        sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi8(high, zero), weights));
+        sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi8(high, zero), weights));
+    }
+
+    const __m128i lowHalf  = _mm_packs_epi32(_mm_sra_epi32(sums[0], shiftCount), _mm_sra_epi32(sums[1], shiftCount));
+    const __m128i highHalf = _mm_packs_epi32(_mm_sra_epi32(sums[2], shiftCount), _mm_sra_epi32(sums[3], shiftCount));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + ix), _mm_packus_epi16(lowHalf, highHalf));
+}
+
+// A row of at least one step ends with a step flush with its end, recomputing a few samples rather than leaving them to the scalar
+// loop; the sources are never the output, so the overlap writes the same values again.
+SIMD_TARGET_SSE2 inline void FixedPointConvolutionRowSSE2(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t begin,
+                                                          size_t end, int32_t bias, int shift)
+{
+    const __m128i biases     = _mm_set1_epi32(bias);
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    size_t        ix         = begin;
+
+    if (end - begin < 16)
+        return FixedPointConvolutionRowScalar(sources, weightPairs, pairs, output, begin, end, bias, shift);
+
+    for (; ix + 16 <= end; ix += 16)
+        FixedPointConvolutionStepSSE2(sources, weightPairs, pairs, output, ix, biases, shiftCount);
+
+    if (ix < end)
+        FixedPointConvolutionStepSSE2(sources, weightPairs, pairs, output, end - 16, biases, shiftCount);
+}
+
+// The same on 32 samples. Unpacking and packing both work within the 128-bit lanes, so the order comes out right as well.
+SIMD_TARGET_AVX2 inline void FixedPointConvolutionStepAVX2(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t ix,
+                                                           __m256i biases, __m128i shiftCount)
+{
+    const __m256i zero    = _mm256_setzero_si256();
+    __m256i       sums[4] = { biases, biases, biases, biases };
+
+    for (size_t pair = 0; pair < pairs; ++pair)
+    {
+        const __m256i weights = _mm256_set1_epi32(static_cast<int>(weightPairs[pair]));
+        const __m256i first   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sources[2 * pair] + ix));
+        const __m256i second  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sources[2 * pair + 1] + ix));
+        const __m256i low     = _mm256_unpacklo_epi8(first, second);
+        const __m256i high    = _mm256_unpackhi_epi8(first, second);
+
+        sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi8(low, zero), weights));
+        sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi8(low, zero), weights));
+        sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi8(high, zero), weights));
+        sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi8(high, zero), weights));
+    }
+
+    const __m256i lowHalf  = _mm256_packs_epi32(_mm256_sra_epi32(sums[0], shiftCount), _mm256_sra_epi32(sums[1], shiftCount));
+    const __m256i highHalf = _mm256_packs_epi32(_mm256_sra_epi32(sums[2], shiftCount), _mm256_sra_epi32(sums[3], shiftCount));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + ix), _mm256_packus_epi16(lowHalf, highHalf));
+}
+
+SIMD_TARGET_AVX2 inline void FixedPointConvolutionRowAVX2(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t begin,
+                                                          size_t end, int32_t bias, int shift)
+{
+    const __m256i biases     = _mm256_set1_epi32(bias);
+    const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+    size_t        ix         = begin;
+
+    if (end - begin < 32)
+        return FixedPointConvolutionRowSSE2(sources, weightPairs, pairs, output, begin, end, bias, shift);
+
+    for (; ix + 32 <= end; ix += 32)
+        FixedPointConvolutionStepAVX2(sources, weightPairs, pairs, output, ix, biases, shiftCount);
+
+    if (ix < end)
+        FixedPointConvolutionStepAVX2(sources, weightPairs, pairs, output, end - 32, biases, shiftCount);
+}
+
+#endif
+
+inline void FixedPointConvolutionRow(const uint8_t* const* sources, const uint32_t* weightPairs, size_t pairs, uint8_t* output, size_t count, int32_t bias, int shift)
+{
+    assert(sources     != NULL);
+    assert(weightPairs != NULL);
+    assert(output      != NULL);
+    assert(shift >= 0 && shift < 31);
+
+    switch (GetSIMDLevel())
+    {
+#if defined(SIMD_X86)
+    case SIMDLevel::AVX2:
+        FixedPointConvolutionRowAVX2(sources, weightPairs, pairs, output, 0, count, bias, shift);
+        break;
+    case SIMDLevel::SSE2:
+        FixedPointConvolutionRowSSE2(sources, weightPairs, pairs, output, 0, count, bias, shift);
+        break;
+#endif
+    default:
+        FixedPointConvolutionRowScalar(sources, weightPairs, pairs, output, 0, count, bias, shift);
+        break;
+    }
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -6,67 +6,270 @@
 
 // +----------------------------------------------< INCLUDE >-----------------------------------------------+
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
-#include <cstdio>
+#include <vector>
 
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
+#include "Histogram Equalization.h"
+#include "Instrumentation.h"
+#include "Parallel Executor.h"
 
-typedef uint8_t byte_t;
+// +---------------------------------------< HISTOGRAM EQUALIZATION >---------------------------------------+
+
+Image& HistogramEqualization(const Image& inputImage, Image& outputImage)
+{
+    Histogram histogram = {};
+
+    return HistogramEqualization(inputImage, outputImage, AccumulateHistogram(inputImage, histogram));
+}
+
+byte_t* CreateEqualizationLUT(byte_t* lut, const Histogram& histogram)
+{
+    assert(lut != NULL);
 
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
+    const uint64_t pixelCount = CountHistogramPixels(histogram);
 
-static const size_t WIDTH  = 880;
-static const size_t HEIGHT = 880;
+    double histogramCDF = 0.0;
 
-byte_t inputImage[WIDTH * HEIGHT];
-byte_t outputImage[WIDTH * HEIGHT];
+    assert(pixelCount != 0);
 
-// +---------------------------------------< HISTOGRAM EQUALIZATION >---------------------------------------+
+    // The table is derived with the same double accumulation the per-pixel path used. An exact integer rounding of
+    // 255 * count / pixelCount differs from it on ties, so this is the only way to keep every output bit unchanged.
+    for (int brightness = 0; brightness < 256; ++brightness)
+    {
+        histogramCDF    = static_cast<double>(histogram[brightness]) / static_cast<double>(pixelCount) + histogramCDF;
+        lut[brightness] = static_cast<byte_t>(255 * histogramCDF + 0.5);
+    }
 
-byte_t* HistogramEqualization(byte_t* inputImage, byte_t* outputImage)
+    return lut;
+}
+
+Image& HistogramEqualization(const Image& inputImage, Image& outputImage, const Histogram& histogram)
+{
+    TraceScope trace("HistogramEqualization", inputImage, outputImage);
+
+    byte_t lut[256];
+
+    return ApplyBrightnessLUT(inputImage, outputImage, CreateEqualizationLUT(lut, histogram));
+}
+
+template <typename Pixel>
+ImageBuffer<Pixel>& HistogramEqualization(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, int bits)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("HistogramEqualization", inputImage, outputImage);
 
-    uint32_t histogram[256]    = { 0 };
-    double   histogramCDF[256] = { 0.0 };
+    typedef PixelSample<Pixel> Sample;
 
-    for (unsigned int iy = 0; iy < HEIGHT; ++iy)
-        for (unsigned int ix = 0; ix < WIDTH; ++ix)
-            histogram[inputImage[iy * WIDTH + ix]]++;
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
 
-    histogramCDF[0] = static_cast<double>(histogram[0]) / static_cast<double>(WIDTH * HEIGHT);
-    for (int brightness = 1; brightness < 256; ++brightness)
-        histogramCDF[brightness] = static_cast<double>(histogram[brightness]) / static_cast<double>(WIDTH * HEIGHT) + histogramCDF[brightness - 1];
+    ChannelHistogram histogram;
 
-    for (unsigned int iy = 0; iy < HEIGHT; ++iy)
-        for (unsigned int ix = 0; ix < WIDTH; ++ix)
-            outputImage[iy * WIDTH + ix] = static_cast<byte_t>(255 * histogramCDF[inputImage[iy * WIDTH + ix]] + 0.5);
+    AccumulateChannelHistogram(inputImage, histogram, bits);
 
-    return outputImage;
+    const size_t        bins       = static_cast<size_t>(1) << bits;
+    const uint64_t      pixelCount = inputImage.Width() * inputImage.Height();
+    std::vector<Sample> lut(CHANNELS * bins);
+
+    if (pixelCount == 0)
+        return CopyImage(inputImage, outputImage);
+
+    // The same double accumulation as CreateEqualizationLUT, scaled to the largest bits-bit value
+    for (size_t channel = 0; channel < CHANNELS; ++channel)
+    {
+        double histogramCDF = 0.0;
+
+        for (size_t bin = 0; bin < bins; ++bin)
+        {
+            histogramCDF              = static_cast<double>(histogram[channel * bins + bin]) / static_cast<double>(pixelCount) + histogramCDF;
+            lut[channel * bins + bin] = static_cast<Sample>((bins - 1) * histogramCDF + 0.5);
+        }
+    }
+
+    return ApplyChannelLUT(inputImage, outputImage, lut.data(), bits);
 }
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
+template Image&     HistogramEqualization(const Image&, Image&, int);
+template WideImage& HistogramEqualization(const WideImage&, WideImage&, int);
+template RGBImage&  HistogramEqualization(const RGBImage&, RGBImage&, int);
+template RGBAImage& HistogramEqualization(const RGBAImage&, RGBAImage&, int);
 
-int main(void)
+// +---------------------------------------< ADAPTIVE EQUALIZATION >----------------------------------------+
+
+// Caps every bin at clipLimit times the mean bin count and spreads the clipped pixels over all bins, which bounds the slope of the
+// tile's mapping and so the noise it can amplify in flat regions. A clipLimit of 0 keeps the histogram as it is.
+static void ClipHistogram(Histogram& histogram, float clipLimit)
 {
-    static const char* INPUT_RAW_FILE_NAME  = "chest.raw";
-    static const char* OUTPUT_RAW_FILE_NAME = "chest_Equalization.raw";
+    if (clipLimit <= 0.0F)
+        return;
+
+    const uint64_t limit  = std::max<uint64_t>(1, static_cast<uint64_t>(clipLimit * CountHistogramPixels(histogram) / 256));
+    uint64_t       excess = 0;
 
-    FILE* fileStream;
+    for (int brightness = 0; brightness < 256; ++brightness)
+        if (histogram[brightness] > limit)
+        {
+            excess                += histogram[brightness] - limit;
+            histogram[brightness]  = limit;
+        }
 
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    for (int brightness = 0; brightness < 256; ++brightness)
+        histogram[brightness] += excess / 256;
 
-    HistogramEqualization(inputImage, outputImage);
+    // The last few clipped pixels go to evenly spaced bins, so no brightness range is favoured
+    const uint64_t remainder = excess % 256;
 
-    fileStream = fopen(OUTPUT_RAW_FILE_NAME, "w+b");
-    fwrite(outputImage, sizeof(outputImage), 1, fileStream);
-    fclose(fileStream);
+    for (uint64_t index = 0; index < remainder; ++index)
+        histogram[index * 256 / remainder]++;
+}
 
-    return 0;
+// For every column (or row), the tile whose centre lies at or before it and the weight of the tile after that one. Before the first
+// centre and past the last the weight is 0, so the blend falls back to the nearest tile along the image border.
+static void CreateTileBlend(const std::vector<size_t>& tileBounds, size_t length, std::vector<int>& tileIndices, std::vector<float>& tileWeights)
+{
+    const int tileCount = static_cast<int>(tileBounds.size()) - 1;
+
+    std::vector<float> centres(tileCount);
+
+    for (int tile = 0; tile < tileCount; ++tile)
+        centres[tile] = (tileBounds[tile] + tileBounds[tile + 1] - 1) / 2.0F;
+
+    tileIndices.resize(length);
+    tileWeights.resize(length);
+
+    int tile = 0;
+
+    for (size_t position = 0; position < length; ++position)
+    {
+        while (tile + 1 < tileCount && position >= centres[tile + 1])
+            ++tile;
+
+        tileIndices[position] = tile;
+        tileWeights[position] = (tile + 1 < tileCount && position > centres[tile]) ? ((position - centres[tile]) / (centres[tile + 1] - centres[tile])) : (0.0F);
+    }
+}
+
+Image& ContrastLimitedEqualization(const Image& inputImage, Image& outputImage, int tilesX, int tilesY, float clipLimit)
+{
+    TraceScope trace("ContrastLimitedEqualization", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
+    assert(tilesX > 0 && tilesY > 0);
+
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
+
+    outputImage.Resize(width, height);
+
+    if (inputImage.IsEmpty())
+        return outputImage;
+
+    tilesX = static_cast<int>(std::min<size_t>(tilesX, width));
+    tilesY = static_cast<int>(std::min<size_t>(tilesY, height));
+
+    // Tile (tx, ty) covers columns tileColumns[tx] ... tileColumns[tx + 1] - 1 and rows tileRows[ty] ... tileRows[ty + 1] - 1
+    std::vector<size_t> tileColumns(tilesX + 1);
+    std::vector<size_t> tileRows(tilesY + 1);
+    std::vector<byte_t> tileLUTs(static_cast<size_t>(tilesX) * tilesY * 256);
+
+    for (int tx = 0; tx <= tilesX; ++tx)
+        tileColumns[tx] = tx * width / tilesX;
+    for (int ty = 0; ty <= tilesY; ++ty)
+        tileRows[ty] = ty * height / tilesY;
+
+    // Every row of tiles streams through its image rows once, each row segment counting into the histogram of its own tile, so
+    // the counting costs one pass over the image whatever the number of tiles. Rows of tiles run in parallel.
+    ParallelForRows(0, tilesY, [&](size_t bandBegin, size_t bandEnd) {
+        std::vector<Histogram> histograms(tilesX);
+
+        for (size_t ty = bandBegin; ty < bandEnd; ++ty)
+        {
+            for (Histogram& histogram : histograms)
+                histogram.fill(0);
+
+            for (size_t iy = tileRows[ty]; iy < tileRows[ty + 1]; ++iy)
+            {
+                const byte_t* inputRow = inputImage.Row(iy);
+
+                for (int tx = 0; tx < tilesX; ++tx)
+                    for (size_t ix = tileColumns[tx]; ix < tileColumns[tx + 1]; ++ix)
+                        histograms[tx][inputRow[ix]]++;
+            }
+
+            for (int tx = 0; tx < tilesX; ++tx)
+            {
+                ClipHistogram(histograms[tx], clipLimit);
+                CreateEqualizationLUT(&tileLUTs[(ty * tilesX + tx) * 256], histograms[tx]);
+            }
+        }
+    }, 1);
+
+    std::vector<int>   columnTiles, rowTiles;
+    std::vector<float> columnWeights, rowWeights;
+
+    CreateTileBlend(tileColumns, width, columnTiles, columnWeights);
+    CreateTileBlend(tileRows, height, rowTiles, rowWeights);
+
+    // The blend runs in 8-bit fixed point, weights 0 ... 256, which keeps the hot loop in integer registers
+    std::vector<int> columnFixedWeights(width);
+
+    for (size_t ix = 0; ix < width; ++ix)
+        columnFixedWeights[ix] = static_cast<int>(columnWeights[ix] * 256 + 0.5F);
+
+    // Each pixel blends the mappings of the four tiles whose centres surround it, so the tile seams do not show. The vertical half
+    // of the blend depends on the row only, so on a row wide enough to pay for it it is done once for all 256 brightnesses of every
+    // tile column, and only again when the tile row or the weight changes, as they do not in the top and bottom half tiles. A row
+    // narrower than that, such as one under a fine tile grid, blends the two tile rows per pixel instead.
+    const bool blendRows = static_cast<size_t>(tilesX) * 256 <= width;
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        std::vector<int> rowLUTs((blendRows) ? (tilesX * 256) : (0));
+        int              rowLUTTile   = -1;
+        int              rowLUTWeight = -1;
+
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const byte_t* inputRow   = inputImage.Row(iy);
+            byte_t*       outputRow  = outputImage.Row(iy);
+            const byte_t* topLUTs    = &tileLUTs[rowTiles[iy] * tilesX * 256];
+            const byte_t* bottomLUTs = &tileLUTs[std::min(rowTiles[iy] + 1, tilesY - 1) * tilesX * 256];
+            const int     rowWeight  = static_cast<int>(rowWeights[iy] * 256 + 0.5F);
+
+            if (!blendRows)
+            {
+                for (size_t ix = 0; ix < width; ++ix)
+                {
+                    const int leftIndex  = columnTiles[ix] * 256 + inputRow[ix];
+                    const int rightIndex = std::min(columnTiles[ix] + 1, tilesX - 1) * 256 + inputRow[ix];
+                    const int left       = topLUTs[leftIndex] * 256 + rowWeight * (bottomLUTs[leftIndex] - topLUTs[leftIndex]);
+                    const int right      = topLUTs[rightIndex] * 256 + rowWeight * (bottomLUTs[rightIndex] - topLUTs[rightIndex]);
+
+                    outputRow[ix] = static_cast<byte_t>((left * 256 + columnFixedWeights[ix] * (right - left) + 32768) >> 16);
+                }
+
+                continue;
+            }
+
+            if (rowTiles[iy] != rowLUTTile || rowWeight != rowLUTWeight)
+            {
+                for (int index = 0; index < tilesX * 256; ++index)
+                    rowLUTs[index] = topLUTs[index] * 256 + rowWeight * (bottomLUTs[index] - topLUTs[index]);
+
+                rowLUTTile   = rowTiles[iy];
+                rowLUTWeight = rowWeight;
+            }
+
+            for (size_t ix = 0; ix < width; ++ix)
+            {
+                const int left  = rowLUTs[columnTiles[ix] * 256 + inputRow[ix]];
+                const int right = rowLUTs[std::min(columnTiles[ix] + 1, tilesX - 1) * 256 + inputRow[ix]];
+
+                outputRow[ix] = static_cast<byte_t>((left * 256 + columnFixedWeights[ix] * (right - left) + 32768) >> 16);
+            }
+        }
+    });
+
+    return outputImage;
 }
 
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
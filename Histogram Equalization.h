@@ -0,0 +1,35 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef HISTOGRAM_EQUALIZATION_H
+#define HISTOGRAM_EQUALIZATION_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Histogram.h"
+#include "Image.h"
+
+// +---------------------------------------< HISTOGRAM EQUALIZATION >---------------------------------------+
+
+Image& HistogramEqualization(const Image& inputImage, Image& outputImage);
+
+// Equalizes inputImage with a precomputed histogram, which may describe a larger image that inputImage is only a strip of
+Image& HistogramEqualization(const Image& inputImage, Image& outputImage, const Histogram& histogram);
+
+// The equalized brightness of each input brightness, as a 256-entry table for ApplyBrightnessLUT
+byte_t* CreateEqualizationLUT(byte_t* lut, const Histogram& histogram);
+
+// Equalizes every channel of any pixel format with its own histogram of 2^bits bins onto 0 ... 2^bits - 1, in one counting and
+// one mapping pass over the interleaved samples. Equals the overloads above for 8-bit grayscale.
+template <typename Pixel>
+ImageBuffer<Pixel>& HistogramEqualization(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, int bits = 8 * sizeof(PixelSample<Pixel>));
+
+// +---------------------------------------< ADAPTIVE EQUALIZATION >----------------------------------------+
+
+// Contrast-limited adaptive histogram equalization. The image is cut into tilesX x tilesY tiles, each tile is equalized with its own
+// histogram clipped at clipLimit times the mean bin count (0 for no clipping), and every pixel blends the mappings of the four
+// nearest tile centres bilinearly.
+Image& ContrastLimitedEqualization(const Image& inputImage, Image& outputImage, int tilesX = 8, int tilesY = 8, float clipLimit = 2.0F);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
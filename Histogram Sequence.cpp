@@ -0,0 +1,175 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Histogram Equalization.h"
+#include "Histogram Sequence.h"
+#include "Instrumentation.h"
+#include "Parallel Executor.h"
+
+// +-----------------------------------------< HISTOGRAM SEQUENCE >-----------------------------------------+
+
+HistogramSequence::HistogramSequence(const HistogramLUT& createLUT, float smoothing, float threshold, size_t tileSize)
+    : createLUT(createLUT), smoothing(smoothing), threshold(threshold), tileSize(tileSize)
+{
+    assert(createLUT != nullptr);
+    assert(smoothing >= 0.0F && smoothing < 1.0F);
+    assert(threshold >= 0.0F);
+    assert(tileSize > 0 && tileSize <= 4096);
+
+    Reset();
+}
+
+HistogramSequence HistogramSequence::Equalization(float smoothing, float threshold)
+{
+    return HistogramSequence([](const Histogram& histogram, byte_t* lut) {
+        CreateEqualizationLUT(lut, histogram);
+    }, smoothing, threshold);
+}
+
+HistogramSequence HistogramSequence::Specification(BOI boi, const byte_t maxBrightness, float smoothing, float threshold)
+{
+    return HistogramSequence([boi, maxBrightness](const Histogram& histogram, byte_t* lut) {
+        CreateSpecificationLUT(lut, histogram, boi, maxBrightness);
+    }, smoothing, threshold);
+}
+
+void HistogramSequence::Reset()
+{
+    previousFrame = Image();
+    tileHistograms.clear();
+    histogram  = Histogram{};
+    statistics = HistogramSequenceStatistics{};
+}
+
+const Histogram& HistogramSequence::GetHistogram() const
+{
+    return histogram;
+}
+
+const HistogramSequenceStatistics& HistogramSequence::GetStatistics() const
+{
+    return statistics;
+}
+
+// The largest difference of the two cumulative histograms, in pixels
+static uint64_t CDFDistance(const Histogram& histogram, const Histogram& otherHistogram)
+{
+    uint64_t cumulative = 0, otherCumulative = 0, distance = 0;
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+    {
+        cumulative      += histogram[brightness];
+        otherCumulative += otherHistogram[brightness];
+        distance         = std::max(distance, (cumulative > otherCumulative) ? (cumulative - otherCumulative) : (otherCumulative - cumulative));
+    }
+
+    return distance;
+}
+
+Image& HistogramSequence::Process(const Image& frame, Image& outputImage)
+{
+    TraceScope trace("HistogramSequence", frame, outputImage);
+
+    assert(!frame.IsEmpty());
+
+    const size_t width  = frame.Width();
+    const size_t height = frame.Height();
+    const size_t tilesX = (width + tileSize - 1) / tileSize;
+    const size_t tilesY = (height + tileSize - 1) / tileSize;
+    const bool   first  = previousFrame.Width() != width || previousFrame.Height() != height;
+
+    if (first)
+    {
+        Reset();
+        previousFrame.Resize(width, height);
+        tileHistograms.assign(tilesX * tilesY, TileHistogram{});
+    }
+
+    // Every band of tile rows sums what its changed tiles add to and take from the histogram. The bins are unsigned, but their
+    // sum wraps back to the right count whatever order the differences come in.
+    struct Delta
+    {
+        Histogram histogram;
+        size_t    tilesCounted;
+    };
+
+    const Delta delta = ParallelReduceRows(0, tilesY, Delta{}, [&](size_t bandBegin, size_t bandEnd, Delta& bandDelta) {
+        for (size_t ty = bandBegin; ty < bandEnd; ++ty)
+        {
+            const size_t rowBegin = ty * tileSize;
+            const size_t rowEnd   = std::min(height, rowBegin + tileSize);
+
+            for (size_t tx = 0; tx < tilesX; ++tx)
+            {
+                const size_t columnBegin = tx * tileSize;
+                const size_t columns     = std::min(width, columnBegin + tileSize) - columnBegin;
+                bool         changed     = first;
+
+                for (size_t iy = rowBegin; iy < rowEnd && !changed; ++iy)
+                    changed = memcmp(frame.Row(iy) + columnBegin, previousFrame.Row(iy) + columnBegin, columns) != 0;
+
+                if (!changed)
+                    continue;
+
+                TileHistogram& tileHistogram = tileHistograms[ty * tilesX + tx];
+                TileHistogram  counts        = {};
+
+                for (size_t iy = rowBegin; iy < rowEnd; ++iy)
+                {
+                    const byte_t* frameRow = frame.Row(iy) + columnBegin;
+
+                    for (size_t ix = 0; ix < columns; ++ix)
+                        counts[frameRow[ix]]++;
+                    memcpy(previousFrame.Row(iy) + columnBegin, frameRow, columns);
+                }
+
+                for (int brightness = 0; brightness < 256; ++brightness)
+                    bandDelta.histogram[brightness] += static_cast<uint64_t>(counts[brightness]) - tileHistogram[brightness];
+
+                tileHistogram = counts;
+                bandDelta.tilesCounted++;
+            }
+        }
+    }, [](Delta& delta, const Delta& bandDelta) {
+        for (int brightness = 0; brightness < 256; ++brightness)
+            delta.histogram[brightness] += bandDelta.histogram[brightness];
+        delta.tilesCounted += bandDelta.tilesCounted;
+    }, 1);
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+        histogram[brightness] += delta.histogram[brightness];
+
+    statistics.frames++;
+    statistics.tilesCounted += delta.tilesCounted;
+    statistics.tilesCarried += tilesX * tilesY - delta.tilesCounted;
+
+    // The target table is kept while the distribution stays within threshold of the one it was made from; a threshold of 0 only
+    // keeps it for a histogram that did not change at all
+    if (first || CDFDistance(histogram, targetHistogram) > threshold * static_cast<double>(width * height))
+    {
+        createLUT(histogram, targetLUT);
+        targetHistogram = histogram;
+        statistics.tablesCreated++;
+    }
+
+    byte_t lut[256];
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+    {
+        smoothedLUT[brightness] = (first) ? (targetLUT[brightness]) : (smoothing * smoothedLUT[brightness] + (1.0F - smoothing) * targetLUT[brightness]);
+        lut[brightness]         = static_cast<byte_t>(smoothedLUT[brightness] + 0.5F);
+    }
+
+    return ApplyBrightnessLUT(frame, outputImage, lut);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
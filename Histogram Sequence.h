@@ -0,0 +1,75 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef HISTOGRAM_SEQUENCE_H
+#define HISTOGRAM_SEQUENCE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "Histogram Specification.h"
+#include "Histogram.h"
+#include "Image.h"
+
+// +-----------------------------------------< HISTOGRAM SEQUENCE >-----------------------------------------+
+
+struct HistogramSequenceStatistics
+{
+    size_t frames;        // Frames mapped since the last reset
+    size_t tilesCounted;  // Tiles counted again because a pixel of theirs changed
+    size_t tilesCarried;  // Tiles whose counts were carried over from the frame before
+    size_t tablesCreated; // Frames whose histogram moved past the threshold and got a new target table
+};
+
+// Histogram equalization or specification of a video, one frame after the other. Consecutive frames differ only slightly, so the
+// histogram is kept across frames and updated from the tiles that changed: every tile keeps its own counts, and only the tiles
+// whose pixels differ from the frame before are counted again. The target table is only recreated when the cumulative histogram
+// moved by more than threshold, the largest difference of the two CDFs, and the table actually applied follows it with
+// exponential smoothing, so the brightness of a shot does not flicker from frame to frame.
+// With the defaults every frame is mapped exactly as HistogramEqualization or HistogramSpecification would map it.
+class HistogramSequence
+{
+public:
+    // A table made from the histogram of the current frame
+    typedef std::function<void(const Histogram& histogram, byte_t* lut)> HistogramLUT;
+
+    // smoothing is the weight of the previous table in the one applied, 0 ... 1 exclusive; 0 applies every target table as it is
+    explicit HistogramSequence(const HistogramLUT& createLUT, float smoothing = 0.0F, float threshold = 0.0F, size_t tileSize = 64);
+
+    static HistogramSequence Equalization(float smoothing = 0.0F, float threshold = 0.0F);
+
+    static HistogramSequence Specification(BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255, float smoothing = 0.0F, float threshold = 0.0F);
+
+    // Maps the next frame of the sequence. outputImage may be frame itself. A frame of another size starts the sequence over.
+    Image& Process(const Image& frame, Image& outputImage);
+
+    // Forgets the frames seen so far, so the next one is counted in full, e.g. at a cut
+    void Reset();
+
+    // The histogram of the last frame
+    const Histogram& GetHistogram() const;
+
+    const HistogramSequenceStatistics& GetStatistics() const;
+
+private:
+    // A tile never holds four gigapixels, so its counts stay 32-bit
+    typedef std::array<uint32_t, 256> TileHistogram;
+
+    HistogramLUT                createLUT;
+    float                       smoothing;
+    float                       threshold;
+    size_t                      tileSize;
+    Image                       previousFrame;
+    std::vector<TileHistogram>  tileHistograms;
+    Histogram                   histogram;
+    Histogram                   targetHistogram;
+    byte_t                      targetLUT[256];
+    float                       smoothedLUT[256];
+    HistogramSequenceStatistics statistics;
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
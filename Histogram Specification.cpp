@@ -6,33 +6,16 @@
 
 // +----------------------------------------------< INCLUDE >-----------------------------------------------+
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
-#include <cstdio>
 
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
-
-typedef uint8_t byte_t;
-
-// +---------------------------------------< BRIGHTNESS OF INTEREST >---------------------------------------+
-
-enum class BOI : uint8_t
-{
-    DARKNESS  = 0,
-    LIGHTNESS = 1
-};
-
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
-
-static const size_t WIDTH  = 256;
-static const size_t HEIGHT = 256;
-
-byte_t inputImage[WIDTH * HEIGHT];
-byte_t outputImage[WIDTH * HEIGHT];
+#include "Histogram Specification.h"
+#include "Instrumentation.h"
 
 // +--------------------------------------< HISTOGRAM SPECIFICATION >---------------------------------------+
 
-float* CreateDesiredCDF(float* desiredCDF, BOI boi, const byte_t maxBrightness = 255)
+float* CreateDesiredCDF(float* desiredCDF, BOI boi, const byte_t maxBrightness)
 {
     assert(desiredCDF != NULL);
 
@@ -45,55 +28,53 @@ float* CreateDesiredCDF(float* desiredCDF, BOI boi, const byte_t maxBrightness =
     return desiredCDF;
 }
 
-byte_t* HistogramSpecification(byte_t* inputImage, byte_t* outputImage, BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255)
+byte_t* CreateSpecificationLUT(byte_t* lut, const Histogram& histogram, BOI boi, const byte_t maxBrightness)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    assert(lut != NULL);
 
-    uint32_t histogram[256]     = { 0 };
-    float    inputImageCDF[256] = { 0.0F };
-    float    desiredCDF[256]    = { 0.0F };
+    const uint64_t pixelCount = CountHistogramPixels(histogram);
 
-    for (unsigned int iy = 0; iy < HEIGHT; ++iy)
-        for (unsigned int ix = 0; ix < WIDTH; ++ix)
-            histogram[inputImage[iy * WIDTH + ix]]++;
+    float inputImageCDF[256] = { 0.0F };
+    float desiredCDF[256]    = { 0.0F };
+    float reachableCDF[256];
+
+    assert(pixelCount != 0);
 
     for (int brightness = 0; brightness < maxBrightness + 1; ++brightness)
-        inputImageCDF[brightness] = static_cast<float>(histogram[brightness]) / static_cast<float>(WIDTH * HEIGHT) + ((brightness > 0) ? (inputImageCDF[brightness - 1]) : (0));
+        inputImageCDF[brightness] = static_cast<float>(histogram[brightness]) / static_cast<float>(pixelCount) + ((brightness > 0) ? (inputImageCDF[brightness - 1]) : (0));
     CreateDesiredCDF(desiredCDF, boi);
 
-    for (unsigned int iy = 0; iy < HEIGHT; ++iy)
-        for (unsigned int ix = 0; ix < WIDTH; ++ix)
-            for (int brightness = 0; brightness < maxBrightness + 1; ++brightness)
-                if (inputImageCDF[inputImage[iy * WIDTH + ix]] <= desiredCDF[brightness])
-                {
-                    outputImage[iy * WIDTH + ix] = brightness;
-                    break;
-                }
+    // The first brightness whose desired CDF reaches a value is the first one whose running maximum does, and the running maximum
+    // is sorted, so a binary search finds it for any target distribution, rising or falling
+    reachableCDF[0] = desiredCDF[0];
+    for (int brightness = 1; brightness < maxBrightness + 1; ++brightness)
+        reachableCDF[brightness] = std::max(reachableCDF[brightness - 1], desiredCDF[brightness]);
 
-    return outputImage;
-}
+    // A brightness whose CDF no desired CDF reaches is left as it is
+    for (int brightness = 0; brightness < 256; ++brightness)
+    {
+        const float* specified = std::lower_bound(reachableCDF, reachableCDF + maxBrightness + 1, inputImageCDF[brightness]);
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
+        lut[brightness] = (specified != reachableCDF + maxBrightness + 1) ? (static_cast<byte_t>(specified - reachableCDF)) : (brightness);
+    }
 
-int main(void)
-{
-    static const char* INPUT_RAW_FILE_NAME  = "Room.raw";
-    static const char* OUTPUT_RAW_FILE_NAME = "Room_Specification.raw";
+    return lut;
+}
 
-    FILE* fileStream;
+Image& HistogramSpecification(const Image& inputImage, Image& outputImage, BOI boi, const byte_t maxBrightness)
+{
+    Histogram histogram = {};
 
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    return HistogramSpecification(inputImage, outputImage, AccumulateHistogram(inputImage, histogram), boi, maxBrightness);
+}
 
-    HistogramSpecification(inputImage, outputImage);
+Image& HistogramSpecification(const Image& inputImage, Image& outputImage, const Histogram& histogram, BOI boi, const byte_t maxBrightness)
+{
+    TraceScope trace("HistogramSpecification", inputImage, outputImage);
 
-    fileStream = fopen(OUTPUT_RAW_FILE_NAME, "w+b");
-    fwrite(outputImage, sizeof(outputImage), 1, fileStream);
-    fclose(fileStream);
+    byte_t lut[256];
 
-    return 0;
+    return ApplyBrightnessLUT(inputImage, outputImage, CreateSpecificationLUT(lut, histogram, boi, maxBrightness));
 }
 
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
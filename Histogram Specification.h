@@ -0,0 +1,36 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef HISTOGRAM_SPECIFICATION_H
+#define HISTOGRAM_SPECIFICATION_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cinttypes>
+
+#include "Histogram.h"
+#include "Image.h"
+
+// +---------------------------------------< BRIGHTNESS OF INTEREST >---------------------------------------+
+
+enum class BOI : uint8_t
+{
+    DARKNESS  = 0,
+    LIGHTNESS = 1
+};
+
+// +--------------------------------------< HISTOGRAM SPECIFICATION >---------------------------------------+
+
+float* CreateDesiredCDF(float* desiredCDF, BOI boi, const byte_t maxBrightness = 255);
+
+Image& HistogramSpecification(const Image& inputImage, Image& outputImage, BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255);
+
+// Specifies inputImage with a precomputed histogram, which may describe a larger image that inputImage is only a strip of
+Image& HistogramSpecification(const Image& inputImage, Image& outputImage, const Histogram& histogram, BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255);
+
+// The brightness each input brightness is specified to, as a 256-entry table for ApplyBrightnessLUT. Frames that share a histogram
+// or are close enough to one, like the frames of a shot, can reuse one table instead of specifying every frame from scratch.
+byte_t* CreateSpecificationLUT(byte_t* lut, const Histogram& histogram, BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
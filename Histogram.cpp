@@ -0,0 +1,226 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+
+#include "Histogram.h"
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Parallel Executor.h"
+
+// +---------------------------------------------< HISTOGRAM >----------------------------------------------+
+
+Histogram& AccumulateHistogram(const Image& inputImage, Histogram& histogram)
+{
+    TraceScope trace("AccumulateHistogram");
+
+    trace.AddTraffic(inputImage.Width() * inputImage.Height(), inputImage.Width() * inputImage.Height(), 0);
+
+    const size_t width = inputImage.Width();
+
+    // Consecutive pixels count into four banks in rotation, so a run of equal values does not wait on one counter for every
+    // increment. The 32-bit banks are flushed into the 64-bit band partial before a bank could overflow and summed at the end.
+    static const size_t BANKS       = 4;
+    static const size_t FLUSH_LIMIT = UINT32_MAX;
+
+    const Histogram imageHistogram = ParallelReduceRows(0, inputImage.Height(), Histogram(),
+        [&](size_t bandBegin, size_t bandEnd, Histogram& bandHistogram) {
+            uint32_t banks[BANKS][256] = {};
+            size_t   pending           = 0;
+
+            const auto flush = [&]() {
+                for (int brightness = 0; brightness < 256; ++brightness)
+                    for (size_t bank = 0; bank < BANKS; ++bank)
+                    {
+                        bandHistogram[brightness] += banks[bank][brightness];
+                        banks[bank][brightness]    = 0;
+                    }
+
+                pending = 0;
+            };
+
+            for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+            {
+                const byte_t* inputRow = inputImage.Row(iy);
+                size_t        ix       = 0;
+
+                if (pending + width > FLUSH_LIMIT)
+                    flush();
+
+                for (; ix + BANKS <= width; ix += BANKS)
+                {
+                    banks[0][inputRow[ix]]++;
+                    banks[1][inputRow[ix + 1]]++;
+                    banks[2][inputRow[ix + 2]]++;
+                    banks[3][inputRow[ix + 3]]++;
+                }
+
+                for (; ix < width; ++ix)
+                    banks[0][inputRow[ix]]++;
+
+                pending += width;
+            }
+
+            flush();
+        },
+        [](Histogram& histogram, const Histogram& bandHistogram) {
+            for (int brightness = 0; brightness < 256; ++brightness)
+                histogram[brightness] += bandHistogram[brightness];
+        });
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+        histogram[brightness] += imageHistogram[brightness];
+
+    return histogram;
+}
+
+uint64_t CountHistogramPixels(const Histogram& histogram)
+{
+    uint64_t pixelCount = 0;
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+        pixelCount += histogram[brightness];
+
+    return pixelCount;
+}
+
+// +-------------------------------------------< BRIGHTNESS LUT >-------------------------------------------+
+
+Image& ApplyBrightnessLUT(const Image& inputImage, Image& outputImage, const byte_t* lut)
+{
+    TraceScope trace("ApplyBrightnessLUT", inputImage, outputImage);
+
+    assert(lut != NULL);
+
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
+
+    outputImage.Resize(width, height);
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const byte_t* inputRow  = inputImage.Row(iy);
+            byte_t*       outputRow = outputImage.Row(iy);
+
+            for (size_t ix = 0; ix < width; ++ix)
+                outputRow[ix] = lut[inputRow[ix]];
+        }
+    });
+
+    return outputImage;
+}
+
+// +-----------------------------------------< CHANNEL HISTOGRAM >------------------------------------------+
+
+template <typename Pixel>
+ChannelHistogram& AccumulateChannelHistogram(const ImageBuffer<Pixel>& inputImage, ChannelHistogram& histogram, int bits)
+{
+    TraceScope trace("AccumulateChannelHistogram");
+
+    trace.AddTraffic(inputImage.Width() * inputImage.Height(), inputImage.Width() * inputImage.Height() * sizeof(Pixel), 0);
+
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(bits > 0 && bits <= static_cast<int>(8 * sizeof(PixelSample<Pixel>)));
+
+    const size_t samples  = inputImage.Width() * CHANNELS;
+    const size_t bins     = static_cast<size_t>(1) << bits;
+    const size_t maxValue = bins - 1;
+
+    histogram.resize(CHANNELS * bins, 0);
+
+    // As in AccumulateHistogram every band counts in 32 bits and flushes its counts into its 64-bit partial before a bin could
+    // overflow, so neither the partials nor the merged counts ever wrap
+    static const size_t FLUSH_LIMIT = UINT32_MAX;
+
+    const size_t width = inputImage.Width();
+
+    const ChannelHistogram imageHistogram = ParallelReduceRows(0, inputImage.Height(), ChannelHistogram(CHANNELS * bins, 0),
+        [&](size_t bandBegin, size_t bandEnd, ChannelHistogram& bandHistogram) {
+            ScratchBuffer<uint32_t> counts(CHANNELS * bins);
+            size_t                  pending = 0;
+
+            const auto flush = [&]() {
+                for (size_t bin = 0; bin < CHANNELS * bins; ++bin)
+                {
+                    bandHistogram[bin] += counts[bin];
+                    counts[bin]         = 0;
+                }
+
+                pending = 0;
+            };
+
+            std::fill(counts.Data(), counts.Data() + CHANNELS * bins, 0);
+
+            for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+            {
+                const PixelSample<Pixel>* inputRow = SampleRow(inputImage, iy);
+
+                if (pending + width > FLUSH_LIMIT)
+                    flush();
+
+                for (size_t index = 0; index < samples; index += CHANNELS)
+                    for (size_t channel = 0; channel < CHANNELS; ++channel)
+                        counts[channel * bins + std::min<size_t>(inputRow[index + channel], maxValue)]++;
+
+                pending += width;
+            }
+
+            flush();
+        },
+        [](ChannelHistogram& histogram, const ChannelHistogram& bandHistogram) {
+            for (size_t bin = 0; bin < histogram.size(); ++bin)
+                histogram[bin] += bandHistogram[bin];
+        });
+
+    for (size_t bin = 0; bin < histogram.size(); ++bin)
+        histogram[bin] += imageHistogram[bin];
+
+    return histogram;
+}
+
+template ChannelHistogram& AccumulateChannelHistogram(const Image&, ChannelHistogram&, int);
+template ChannelHistogram& AccumulateChannelHistogram(const WideImage&, ChannelHistogram&, int);
+template ChannelHistogram& AccumulateChannelHistogram(const RGBImage&, ChannelHistogram&, int);
+template ChannelHistogram& AccumulateChannelHistogram(const RGBAImage&, ChannelHistogram&, int);
+
+template <typename Pixel>
+ImageBuffer<Pixel>& ApplyChannelLUT(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const PixelSample<Pixel>* lut, int bits)
+{
+    TraceScope trace("ApplyChannelLUT", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
+
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(lut != NULL);
+
+    const size_t samples  = inputImage.Width() * CHANNELS;
+    const size_t height   = inputImage.Height();
+    const size_t bins     = static_cast<size_t>(1) << bits;
+    const size_t maxValue = bins - 1;
+
+    outputImage.Resize(inputImage.Width(), height);
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const Sample* inputRow  = SampleRow(inputImage, iy);
+            Sample*       outputRow = SampleRow(outputImage, iy);
+
+            for (size_t index = 0; index < samples; index += CHANNELS)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                    outputRow[index + channel] = lut[channel * bins + std::min<size_t>(inputRow[index + channel], maxValue)];
+        }
+    });
+
+    return outputImage;
+}
+
+template Image&     ApplyChannelLUT(const Image&, Image&, const byte_t*, int);
+template WideImage& ApplyChannelLUT(const WideImage&, WideImage&, const wbyte_t*, int);
+template RGBImage&  ApplyChannelLUT(const RGBImage&, RGBImage&, const byte_t*, int);
+template RGBAImage& ApplyChannelLUT(const RGBAImage&, RGBAImage&, const byte_t*, int);
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
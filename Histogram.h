@@ -0,0 +1,46 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <array>
+#include <cinttypes>
+#include <vector>
+
+#include "Image.h"
+
+// +---------------------------------------------< HISTOGRAM >----------------------------------------------+
+
+// Brightness counts of an 8-bit image. The bins are 64-bit, so images past four gigapixels cannot overflow them.
+typedef std::array<uint64_t, 256> Histogram;
+
+// Adds the brightness counts of inputImage to histogram, so an image seen one strip at a time can be counted strip by strip
+Histogram& AccumulateHistogram(const Image& inputImage, Histogram& histogram);
+
+uint64_t CountHistogramPixels(const Histogram& histogram);
+
+// +-------------------------------------------< BRIGHTNESS LUT >-------------------------------------------+
+
+// outputImage(x, y) = lut[inputImage(x, y)], the last step of every histogram operation. inputImage and outputImage may be the same.
+Image& ApplyBrightnessLUT(const Image& inputImage, Image& outputImage, const byte_t* lut);
+
+// +-----------------------------------------< CHANNEL HISTOGRAM >------------------------------------------+
+
+// Sample counts of every channel of any pixel format: one histogram of 2^bits bins per channel, back to back. 12-bit scanner data
+// stored in 16-bit samples counts into 4096 bins instead of 65536; samples above 2^bits - 1 count as 2^bits - 1.
+typedef std::vector<uint64_t> ChannelHistogram;
+
+// Adds the sample counts of inputImage to histogram, which is sized on first use
+template <typename Pixel>
+ChannelHistogram& AccumulateChannelHistogram(const ImageBuffer<Pixel>& inputImage, ChannelHistogram& histogram, int bits = 8 * sizeof(PixelSample<Pixel>));
+
+// outputImage sample = lut[channel * 2^bits + sample], every channel through its own table. inputImage and outputImage may be the same.
+template <typename Pixel>
+ImageBuffer<Pixel>& ApplyChannelLUT(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const PixelSample<Pixel>* lut,
+                                    int bits = 8 * sizeof(PixelSample<Pixel>));
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,140 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "Image Pool.h"
+
+// +---------------------------------------------< IMAGE POOL >---------------------------------------------+
+
+static const size_t DEFAULT_POOL_LIMIT = 256 << 20;
+
+struct ImagePool
+{
+    std::mutex                                        mutex;
+    std::multimap<size_t, std::unique_ptr<uint8_t[]>> blocks;
+    size_t                                            limit      = DEFAULT_POOL_LIMIT;
+    ImagePoolStatistics                               statistics = {};
+};
+
+static ImagePool& GetImagePool()
+{
+    static ImagePool imagePool;
+
+    return imagePool;
+}
+
+// Frees the largest idle blocks until the idle bytes fit the limit; the small ones are the most likely to be asked for again
+static void EvictPoolBlocks(ImagePool& imagePool)
+{
+    while (imagePool.statistics.bytesPooled > imagePool.limit)
+    {
+        const auto largest = std::prev(imagePool.blocks.end());
+
+        imagePool.statistics.bytesPooled -= largest->first;
+        imagePool.blocks.erase(largest);
+    }
+}
+
+std::unique_ptr<uint8_t[]> AcquirePoolStorage(size_t& bytes)
+{
+    ImagePool&                 imagePool = GetImagePool();
+    std::unique_ptr<uint8_t[]> storage;
+
+    {
+        std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+        const auto found = imagePool.blocks.lower_bound(bytes);
+
+        imagePool.statistics.acquisitions += 1;
+
+        if (found != imagePool.blocks.end() && found->first / 2 <= bytes)
+        {
+            bytes   = found->first;
+            storage = std::move(found->second);
+            imagePool.blocks.erase(found);
+
+            imagePool.statistics.hits        += 1;
+            imagePool.statistics.bytesPooled -= bytes;
+        }
+
+        imagePool.statistics.bytesInUse     += bytes;
+        imagePool.statistics.peakBytesInUse  = std::max(imagePool.statistics.peakBytesInUse, imagePool.statistics.bytesInUse);
+    }
+
+    // A miss allocates outside the lock, so a large fresh block never holds up the other threads
+    if (storage == nullptr)
+    {
+        storage.reset(new uint8_t[bytes]);
+        RecordImageAllocation(bytes);
+    }
+
+    return storage;
+}
+
+void ReleasePoolStorage(std::unique_ptr<uint8_t[]> storage, size_t bytes)
+{
+    ImagePool& imagePool = GetImagePool();
+
+    std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+    // Foreign blocks, e.g. one an ImageBuffer reallocated on its own, were never counted as in use
+    imagePool.statistics.bytesInUse -= std::min(bytes, imagePool.statistics.bytesInUse);
+
+    if (bytes > imagePool.limit)
+        return;
+
+    imagePool.statistics.bytesPooled += bytes;
+    imagePool.blocks.emplace(bytes, std::move(storage));
+
+    EvictPoolBlocks(imagePool);
+}
+
+void SetImagePoolLimit(size_t bytes)
+{
+    ImagePool& imagePool = GetImagePool();
+
+    std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+    imagePool.limit = bytes;
+    EvictPoolBlocks(imagePool);
+}
+
+void TrimImagePool()
+{
+    ImagePool& imagePool = GetImagePool();
+
+    std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+    imagePool.blocks.clear();
+    imagePool.statistics.bytesPooled = 0;
+}
+
+ImagePoolStatistics GetImagePoolStatistics()
+{
+    ImagePool& imagePool = GetImagePool();
+
+    std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+    return imagePool.statistics;
+}
+
+void ResetImagePoolStatistics()
+{
+    ImagePool& imagePool = GetImagePool();
+
+    std::lock_guard<std::mutex> lock(imagePool.mutex);
+
+    imagePool.statistics.acquisitions   = 0;
+    imagePool.statistics.hits           = 0;
+    imagePool.statistics.peakBytesInUse = imagePool.statistics.bytesInUse;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,147 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef IMAGE_POOL_H
+#define IMAGE_POOL_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstddef>
+#include <memory>
+
+#include "Image.h"
+
+// +---------------------------------------------< IMAGE POOL >---------------------------------------------+
+
+// A process-wide pool of idle image storage, keyed by size. Operations take their temporaries from it through ScratchImage and
+// ScratchBuffer below, so a service calling them over and over reuses the same pages instead of allocating and faulting in fresh
+// ones on every call. The pool is thread-safe; parallel bands take their per-band scratch from it as well.
+struct ImagePoolStatistics
+{
+    size_t acquisitions;   // Blocks handed out
+    size_t hits;           // Blocks handed out from the pool rather than newly allocated
+    size_t bytesInUse;     // Bytes of the blocks handed out and not yet returned
+    size_t peakBytesInUse; // Largest bytesInUse since the last reset
+    size_t bytesPooled;    // Bytes of the idle blocks kept for reuse
+};
+
+// Takes a block of at least bytes bytes, from the pool when an idle one fits without wasting more than half of it. bytes is set to
+// the size of the block handed out.
+std::unique_ptr<uint8_t[]> AcquirePoolStorage(size_t& bytes);
+
+// Returns a block taken from AcquirePoolStorage, or any other block allocated with new uint8_t[]. Blocks that would push the
+// idle bytes above the pool limit are freed instead.
+void ReleasePoolStorage(std::unique_ptr<uint8_t[]> storage, size_t bytes);
+
+// The most idle bytes the pool keeps, 256 MB by default; lowering it frees idle blocks right away
+void SetImagePoolLimit(size_t bytes);
+
+// Frees every idle block
+void TrimImagePool();
+
+ImagePoolStatistics GetImagePoolStatistics();
+
+// Zeroes the counters and restarts the peak from the bytes in use now
+void ResetImagePoolStatistics();
+
+// +-------------------------------------------< SCRATCH IMAGE >--------------------------------------------+
+
+// An image whose storage comes from the pool and goes back to it on destruction. Resize through the ScratchImage itself swaps the
+// storage for a pooled block when it does not fit; kernels taking it as a plain ImageBuffer should find it sized already.
+template <typename Pixel>
+class ScratchImage : public ImageBuffer<Pixel>
+{
+public:
+    ScratchImage()
+    {
+    }
+
+    ScratchImage(size_t width, size_t height)
+    {
+        Resize(width, height);
+    }
+
+    // A pooled copy of image
+    explicit ScratchImage(const ImageBuffer<Pixel>& image)
+        : ScratchImage(image.Width(), image.Height())
+    {
+        CopyImage(image, *this);
+    }
+
+    ScratchImage(const ScratchImage&)            = delete;
+    ScratchImage& operator=(const ScratchImage&) = delete;
+
+    ~ScratchImage()
+    {
+        ReturnStorage();
+    }
+
+    void Resize(size_t width, size_t height)
+    {
+        const size_t pixels = ImageBuffer<Pixel>::AlignedStride(width) * height;
+
+        if (pixels > this->Capacity())
+        {
+            size_t bytes = pixels * sizeof(Pixel) + IMAGE_ALIGNMENT;
+
+            ReturnStorage();
+
+            std::unique_ptr<uint8_t[]> storage = AcquirePoolStorage(bytes);
+
+            this->AdoptStorage(std::move(storage), bytes);
+        }
+
+        ImageBuffer<Pixel>::Resize(width, height);
+    }
+
+private:
+    void ReturnStorage()
+    {
+        size_t                     bytes;
+        std::unique_ptr<uint8_t[]> storage = this->ReleaseStorage(bytes);
+
+        if (storage != nullptr)
+            ReleasePoolStorage(std::move(storage), bytes);
+    }
+};
+
+// +-------------------------------------------< SCRATCH BUFFER >-------------------------------------------+
+
+// count elements of a trivial type on a cache line, from the pool like ScratchImage; for per-band rows and histograms. The
+// elements are uninitialized.
+template <typename Element>
+class ScratchBuffer
+{
+public:
+    explicit ScratchBuffer(size_t count)
+        : bytes(count * sizeof(Element) + IMAGE_ALIGNMENT), storage(AcquirePoolStorage(bytes))
+    {
+        data = reinterpret_cast<Element*>((reinterpret_cast<uintptr_t>(storage.get()) + IMAGE_ALIGNMENT - 1) & ~static_cast<uintptr_t>(IMAGE_ALIGNMENT - 1));
+    }
+
+    ScratchBuffer(const ScratchBuffer&)            = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    ~ScratchBuffer()
+    {
+        ReleasePoolStorage(std::move(storage), bytes);
+    }
+
+    Element* Data()
+    {
+        return data;
+    }
+
+    Element& operator[](size_t index)
+    {
+        return data[index];
+    }
+
+private:
+    size_t                     bytes;
+    std::unique_ptr<uint8_t[]> storage;
+    Element*                   data;
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,33 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef IMAGE_PROCESSING_H
+#define IMAGE_PROCESSING_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Batch Pipeline.h"
+#include "Border Mode.h"
+#include "Bounded Queue.h"
+#include "CPU Feature.h"
+#include "Convolution.h"
+#include "Histogram Equalization.h"
+#include "Histogram Sequence.h"
+#include "Histogram Specification.h"
+#include "Histogram.h"
+#include "Image Pool.h"
+#include "Image Service.h"
+#include "Image.h"
+#include "Instrumentation.h"
+#include "Interpolator.h"
+#include "Mapped Image.h"
+#include "Median Blur.h"
+#include "Operation Graph.h"
+#include "Parallel Executor.h"
+#include "Resampler.h"
+#include "Spatial Averaging.h"
+#include "Strip Processing.h"
+#include "Unsharp Masking.h"
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
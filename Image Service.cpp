@@ -0,0 +1,192 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+
+#include "Image Service.h"
+#include "Instrumentation.h"
+#include "Parallel Executor.h"
+
+// +-------------------------------------------< IMAGE SERVICE >--------------------------------------------+
+
+ImageService::ImageService(const ServiceSettings& settings)
+    : settings(settings), workerCount((settings.workerCount != 0) ? (settings.workerCount) : (std::max(std::thread::hardware_concurrency(), 1U))),
+      statistics(), stop(false)
+{
+    assert(settings.queueCapacity > 0);
+
+    for (size_t worker = 0; worker < workerCount; ++worker)
+        workers.emplace_back(&ImageService::WorkerLoop, this);
+}
+
+ImageService::~ImageService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    notEmpty.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void ImageService::Submit(Image image, const std::shared_ptr<const OperationChain>& chain, const ServiceCallback& callback)
+{
+    Request request = { std::move(image), chain, callback, std::chrono::steady_clock::now() };
+
+    Enqueue(request, true);
+}
+
+std::future<ServiceResult> ImageService::Submit(Image image, const std::shared_ptr<const OperationChain>& chain)
+{
+    const std::shared_ptr<std::promise<ServiceResult>> promise = std::make_shared<std::promise<ServiceResult>>();
+
+    Submit(std::move(image), chain, [promise](ServiceResult& result) {
+        promise->set_value(std::move(result));
+    });
+
+    return promise->get_future();
+}
+
+bool ImageService::TrySubmit(Image image, const std::shared_ptr<const OperationChain>& chain, const ServiceCallback& callback)
+{
+    Request request = { std::move(image), chain, callback, std::chrono::steady_clock::now() };
+
+    return Enqueue(request, false);
+}
+
+ServiceStatistics ImageService::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return statistics;
+}
+
+bool ImageService::Enqueue(Request& request, bool wait)
+{
+    assert(request.chain != nullptr && request.callback != nullptr);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (wait)
+            notFull.wait(lock, [this] { return requests.size() < settings.queueCapacity; });
+        else if (requests.size() >= settings.queueCapacity)
+        {
+            statistics.rejected++;
+
+            return false;
+        }
+
+        requests.push_back(std::move(request));
+        statistics.submitted++;
+    }
+    notEmpty.notify_one();
+
+    return true;
+}
+
+void ImageService::WorkerLoop()
+{
+    std::vector<Request> batch;
+    Image                intermediateImages[2];
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return stop || !requests.empty(); });
+
+            if (requests.empty())
+                return;
+
+            // Small requests are taken together up to the pixel budget, but never more than this worker's share of the queue, so
+            // a burst still spreads over all workers
+            const size_t share  = std::max<size_t>(1, requests.size() / workerCount);
+            size_t       pixels = 0;
+
+            do
+            {
+                pixels += requests.front().image.Width() * requests.front().image.Height();
+                batch.push_back(std::move(requests.front()));
+                requests.pop_front();
+            } while (!requests.empty() && batch.size() < share && pixels <= settings.smallPixels &&
+                     pixels + requests.front().image.Width() * requests.front().image.Height() <= settings.batchPixels);
+
+            statistics.batches++;
+        }
+        notFull.notify_all();
+
+        for (Request& request : batch)
+        {
+            Execute(request, intermediateImages);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            statistics.completed++;
+        }
+        batch.clear();
+    }
+}
+
+void ImageService::Execute(Request& request, Image* intermediateImages)
+{
+    TraceScope trace("ServiceRequest", "service");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto runChain = [&] {
+        const Image* currentImage = &request.image;
+
+        for (size_t index = 0; index < request.chain->size(); ++index)
+        {
+            (*request.chain)[index](*currentImage, intermediateImages[index % 2]);
+            currentImage = &intermediateImages[index % 2];
+        }
+
+        CopyImage(*currentImage, request.image);
+    };
+
+    bool failed = false;
+
+    // A chain that throws, such as on an image too large to allocate, fails its own request and leaves the worker to the next one
+    try
+    {
+        // A small image runs on this thread alone, the other workers being busy with images of their own
+        if (request.image.Width() * request.image.Height() <= settings.smallPixels)
+        {
+            SerialScope serialScope;
+
+            runChain();
+        }
+        else
+            runChain();
+    }
+    catch (const std::exception&)
+    {
+        request.image = Image();
+        failed        = true;
+    }
+
+    const auto    end    = std::chrono::steady_clock::now();
+    ServiceResult result = { std::move(request.image), std::chrono::duration<double, std::milli>(start - request.submitted).count(),
+                             std::chrono::duration<double, std::milli>(end - start).count(), failed };
+
+    try
+    {
+        request.callback(result);
+    }
+    catch (const std::exception&)
+    {
+    }
+    request = Request();
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,112 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef IMAGE_SERVICE_H
+#define IMAGE_SERVICE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Batch Pipeline.h"
+#include "Image.h"
+
+// +-------------------------------------------< IMAGE SERVICE >--------------------------------------------+
+
+// The operations of a request, applied in order like those of a batch pipeline. Requests running side by side may share the chain,
+// so its operations must not keep state between calls; a chain that does, such as one of the video operations, belongs to a single
+// client that waits for each request before submitting the next.
+typedef std::vector<BatchOperation> OperationChain;
+
+struct ServiceSettings
+{
+    size_t workerCount   = 0;       // Worker threads, 0 for one per hardware thread
+    size_t queueCapacity = 256;     // Requests waiting at most; Submit blocks and TrySubmit fails beyond that
+    size_t smallPixels   = 1 << 18; // Images up to this size run serially on their worker, larger ones in bands on the shared pool
+    size_t batchPixels   = 1 << 20; // A worker takes waiting small requests of up to this many pixels in all at once
+};
+
+struct ServiceResult
+{
+    Image  image;     // The result of the chain, in the buffer of the submitted image when it fits
+    double queueMs;   // From the submission to the start of the chain
+    double computeMs; // Running the chain
+    bool   failed;    // The chain threw, the image then being empty
+};
+
+typedef std::function<void(ServiceResult& result)> ServiceCallback;
+
+struct ServiceStatistics
+{
+    size_t submitted; // Requests accepted
+    size_t rejected;  // Requests TrySubmit turned away on a full queue
+    size_t completed; // Requests whose callback has run
+    size_t batches;   // Takes from the queue, each of one large or several small requests
+};
+
+// Runs operation chains on images for an in-process server. Requests wait in one bounded queue, so producers outpacing the workers
+// are held back instead of piling up images. Small images gain nothing from being split into bands, so a worker takes several of
+// them at once and runs them serially, one after the other, while the other workers do the same; larger images run in parallel
+// bands on the shared pool. Every worker keeps its two intermediate images across requests, and the chain writes its result back
+// into the buffer of the submitted image, so a steady stream of requests allocates nothing.
+class ImageService
+{
+public:
+    explicit ImageService(const ServiceSettings& settings = ServiceSettings());
+
+    ImageService(const ImageService&)            = delete;
+    ImageService& operator=(const ImageService&) = delete;
+
+    // Finishes every request submitted so far
+    ~ImageService();
+
+    // Queues image for chain, blocking while the queue is full. callback runs on a worker once the chain is done, or has failed; it
+    // should hand the result over rather than work on it, since the worker waits for it, and anything it throws is dropped.
+    void Submit(Image image, const std::shared_ptr<const OperationChain>& chain, const ServiceCallback& callback);
+
+    std::future<ServiceResult> Submit(Image image, const std::shared_ptr<const OperationChain>& chain);
+
+    // Like Submit, but returns false at once instead of blocking on a full queue, for servers that would rather shed load
+    bool TrySubmit(Image image, const std::shared_ptr<const OperationChain>& chain, const ServiceCallback& callback);
+
+    ServiceStatistics GetStatistics() const;
+
+private:
+    struct Request
+    {
+        Image                                 image;
+        std::shared_ptr<const OperationChain> chain;
+        ServiceCallback                       callback;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    bool Enqueue(Request& request, bool wait);
+
+    void WorkerLoop();
+
+    // Runs the chain of request in the two intermediate images of the worker
+    void Execute(Request& request, Image* intermediateImages);
+
+    const ServiceSettings    settings;
+    const size_t             workerCount;
+    std::vector<std::thread> workers;
+    std::deque<Request>      requests;
+    ServiceStatistics        statistics;
+    bool                     stop;
+
+    mutable std::mutex      mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
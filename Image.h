@@ -0,0 +1,377 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+
+// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
+
+typedef uint8_t  byte_t;
+typedef uint16_t wbyte_t;
+typedef uint32_t lbyte_t;
+
+struct PixelPoint
+{
+    int x;
+    int y;
+};
+
+struct WindowSize
+{
+    int cx;
+    int cy;
+};
+
+// +--------------------------------------------< PIXEL FORMAT >--------------------------------------------+
+
+// Channels interleaved samples, e.g. the red, green and blue of a camera pixel. Kernels see a row of such pixels as a row of
+// Channels times as many samples and process all channels in the same pass.
+template <typename Sample, size_t Channels>
+struct ChannelPixel
+{
+    Sample channels[Channels];
+};
+
+typedef ChannelPixel<byte_t, 3> RGBPixel;
+typedef ChannelPixel<byte_t, 4> RGBAPixel;
+
+// The sample type and channel count of a pixel format, resolved at compile time so every kernel instantiation has fixed channel
+// loops. A plain arithmetic pixel is a single channel.
+template <typename Pixel>
+struct PixelTraits
+{
+    typedef Pixel Sample;
+
+    static const size_t CHANNELS = 1;
+};
+
+template <typename SampleType, size_t Channels>
+struct PixelTraits<ChannelPixel<SampleType, Channels>>
+{
+    typedef SampleType Sample;
+
+    static const size_t CHANNELS = Channels;
+};
+
+template <typename Pixel>
+using PixelSample = typename PixelTraits<Pixel>::Sample;
+
+// The largest sample value of a pixel format, e.g. 65535 for 16-bit grayscale
+template <typename Pixel>
+constexpr PixelSample<Pixel> MaxSample()
+{
+    return std::numeric_limits<PixelSample<Pixel>>::max();
+}
+
+// +-------------------------------------------< IMAGE BUFFER >---------------------------------------------+
+
+// Every owned row starts on a cache line, which is also the widest vector load the kernels use
+static const size_t IMAGE_ALIGNMENT = 64;
+
+// Counts an image buffer allocation towards the running trace scopes of the calling thread; see Instrumentation.h
+void RecordImageAllocation(size_t bytes);
+
+// A width x height grid of pixels whose rows lie stride pixels apart. Owned buffers pad every row to IMAGE_ALIGNMENT and keep
+// their storage across Resize calls that fit, so one buffer can serve a whole batch of mixed resolutions. Borrowed buffers wrap
+// caller memory, which is never freed or reallocated.
+template <typename Pixel>
+class ImageBuffer
+{
+public:
+    ImageBuffer()
+        : width(0), height(0), stride(0), capacity(0), data(NULL)
+    {
+    }
+
+    ImageBuffer(size_t width, size_t height)
+        : ImageBuffer()
+    {
+        Resize(width, height);
+    }
+
+    ImageBuffer(Pixel* data, size_t width, size_t height, size_t stride)
+        : width(width), height(height), stride(stride), capacity(0), data(data)
+    {
+        assert(data != NULL || width * height == 0);
+        assert(stride >= width);
+    }
+
+    ImageBuffer(const ImageBuffer& other)
+        : ImageBuffer(other.width, other.height)
+    {
+        for (size_t iy = 0; iy < height; ++iy)
+            memcpy(Row(iy), other.Row(iy), width * sizeof(Pixel));
+    }
+
+    ImageBuffer(ImageBuffer&& other)
+        : ImageBuffer()
+    {
+        Swap(other);
+    }
+
+    ImageBuffer& operator=(ImageBuffer other)
+    {
+        Swap(other);
+
+        return *this;
+    }
+
+    size_t Width() const
+    {
+        return width;
+    }
+
+    size_t Height() const
+    {
+        return height;
+    }
+
+    size_t Stride() const
+    {
+        return stride;
+    }
+
+    // Pixels the owned storage holds, row padding included
+    size_t Capacity() const
+    {
+        return capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return width == 0 || height == 0;
+    }
+
+    bool IsBorrowed() const
+    {
+        return data != NULL && storage == nullptr;
+    }
+
+    Pixel* Data()
+    {
+        return data;
+    }
+
+    const Pixel* Data() const
+    {
+        return data;
+    }
+
+    Pixel* Row(size_t iy)
+    {
+        assert(iy < height);
+
+        return data + iy * stride;
+    }
+
+    const Pixel* Row(size_t iy) const
+    {
+        assert(iy < height);
+
+        return data + iy * stride;
+    }
+
+    Pixel& operator()(size_t ix, size_t iy)
+    {
+        assert(ix < width && iy < height);
+
+        return data[iy * stride + ix];
+    }
+
+    const Pixel& operator()(size_t ix, size_t iy) const
+    {
+        assert(ix < width && iy < height);
+
+        return data[iy * stride + ix];
+    }
+
+    // Reshapes an owned buffer, reallocating only when the padded rows no longer fit. Pixel values are unspecified afterwards.
+    // A borrowed buffer cannot grow, so it must already have the requested size.
+    void Resize(size_t width, size_t height)
+    {
+        if (width == this->width && height == this->height)
+            return;
+
+        assert(!IsBorrowed());
+
+        const size_t stride = AlignedStride(width);
+
+        if (stride * height > capacity)
+        {
+            storage.reset(new uint8_t[stride * height * sizeof(Pixel) + IMAGE_ALIGNMENT]);
+            RecordImageAllocation(stride * height * sizeof(Pixel) + IMAGE_ALIGNMENT);
+            capacity = stride * height;
+            data     = reinterpret_cast<Pixel*>((reinterpret_cast<uintptr_t>(storage.get()) + IMAGE_ALIGNMENT - 1) & ~static_cast<uintptr_t>(IMAGE_ALIGNMENT - 1));
+        }
+
+        this->width  = width;
+        this->height = height;
+        this->stride = stride;
+    }
+
+    // Takes over storage of the given size in bytes, alignment slack included, for later Resize calls to fill; the buffer is
+    // empty afterwards. This and ReleaseStorage let scratch images recycle their storage, see Image Pool.h.
+    void AdoptStorage(std::unique_ptr<uint8_t[]> storage, size_t bytes)
+    {
+        assert(bytes >= IMAGE_ALIGNMENT);
+
+        this->storage = std::move(storage);
+        width         = 0;
+        height        = 0;
+        stride        = 0;
+        capacity      = (bytes - IMAGE_ALIGNMENT) / sizeof(Pixel);
+        data          = reinterpret_cast<Pixel*>((reinterpret_cast<uintptr_t>(this->storage.get()) + IMAGE_ALIGNMENT - 1) & ~static_cast<uintptr_t>(IMAGE_ALIGNMENT - 1));
+    }
+
+    // Hands the owned storage and its size in bytes over and leaves the buffer empty; NULL for an empty or borrowed buffer
+    std::unique_ptr<uint8_t[]> ReleaseStorage(size_t& bytes)
+    {
+        std::unique_ptr<uint8_t[]> released(std::move(storage));
+
+        bytes    = (released != nullptr) ? (capacity * sizeof(Pixel) + IMAGE_ALIGNMENT) : (0);
+        width    = 0;
+        height   = 0;
+        stride   = 0;
+        capacity = 0;
+        data     = NULL;
+
+        return released;
+    }
+
+    void Swap(ImageBuffer& other)
+    {
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(stride, other.stride);
+        std::swap(capacity, other.capacity);
+        std::swap(data, other.data);
+        std::swap(storage, other.storage);
+    }
+
+    // width rounded up to the fewest pixels whose bytes end on a cache line, which is the least common multiple of IMAGE_ALIGNMENT
+    // and sizeof(Pixel) over sizeof(Pixel): IMAGE_ALIGNMENT / sizeof(Pixel) for the power-of-two formats, 64 pixels for RGB
+    static size_t AlignedStride(size_t width)
+    {
+        size_t divisor   = IMAGE_ALIGNMENT;
+        size_t remainder = sizeof(Pixel);
+
+        while (remainder != 0)
+        {
+            const size_t next = divisor % remainder;
+
+            divisor   = remainder;
+            remainder = next;
+        }
+
+        const size_t pixelsPerStep = IMAGE_ALIGNMENT / divisor;
+
+        return (width + pixelsPerStep - 1) / pixelsPerStep * pixelsPerStep;
+    }
+
+private:
+    size_t width;
+    size_t height;
+    size_t stride;
+    size_t capacity;
+    Pixel* data;
+
+    std::unique_ptr<uint8_t[]> storage;
+};
+
+// The templated kernels are built for the first four: 8-bit and 16-bit grayscale, RGB and RGBA
+typedef ImageBuffer<byte_t>    Image;
+typedef ImageBuffer<wbyte_t>   WideImage;
+typedef ImageBuffer<RGBPixel>  RGBImage;
+typedef ImageBuffer<RGBAPixel> RGBAImage;
+typedef ImageBuffer<lbyte_t>   IntegralImage;
+
+// The samples of row iy, CHANNELS per pixel
+template <typename Pixel>
+PixelSample<Pixel>* SampleRow(ImageBuffer<Pixel>& image, size_t iy)
+{
+    return reinterpret_cast<PixelSample<Pixel>*>(image.Row(iy));
+}
+
+template <typename Pixel>
+const PixelSample<Pixel>* SampleRow(const ImageBuffer<Pixel>& image, size_t iy)
+{
+    return reinterpret_cast<const PixelSample<Pixel>*>(image.Row(iy));
+}
+
+// +--------------------------------------------< IMAGE COPY >----------------------------------------------+
+
+// Resizes outputImage to match inputImage and copies the pixels row by row; a no-op when both are the same buffer
+template <typename Pixel>
+ImageBuffer<Pixel>& CopyImage(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage)
+{
+    if (&inputImage == &outputImage)
+        return outputImage;
+
+    outputImage.Resize(inputImage.Width(), inputImage.Height());
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        memcpy(outputImage.Row(iy), inputImage.Row(iy), inputImage.Width() * sizeof(Pixel));
+
+    return outputImage;
+}
+
+// +----------------------------------------------< RAW I/O >-----------------------------------------------+
+
+// Raw files hold width x height pixels without any header or row padding, each pixel its interleaved samples in native byte order
+template <typename Pixel>
+bool ReadRawImage(const char* fileName, ImageBuffer<Pixel>& image, size_t width, size_t height)
+{
+    assert(fileName != NULL);
+
+    FILE* fileStream = fopen(fileName, "rb");
+
+    if (fileStream == NULL)
+        return false;
+
+    image.Resize(width, height);
+
+    bool succeeded = true;
+
+    for (size_t iy = 0; iy < height && succeeded; ++iy)
+        succeeded = fread(image.Row(iy), sizeof(Pixel), width, fileStream) == width;
+    fclose(fileStream);
+
+    return succeeded;
+}
+
+template <typename Pixel>
+bool WriteRawImage(const char* fileName, const ImageBuffer<Pixel>& image)
+{
+    assert(fileName != NULL);
+
+    FILE* fileStream = fopen(fileName, "w+b");
+
+    if (fileStream == NULL)
+        return false;
+
+    bool succeeded = true;
+
+    for (size_t iy = 0; iy < image.Height() && succeeded; ++iy)
+        succeeded = fwrite(image.Row(iy), sizeof(Pixel), image.Width(), fileStream) == image.Width();
+    fclose(fileStream);
+
+    return succeeded;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,253 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Image Pool.h"
+#include "Instrumentation.h"
+
+// +------------------------------------------< INSTRUMENTATION >-------------------------------------------+
+
+std::atomic<bool> instrumentationEnabled(false);
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+    int64_t     begin;
+    int64_t     duration;
+    uint64_t    pixels;
+    uint64_t    bytesRead;
+    uint64_t    bytesWritten;
+    uint64_t    allocations;
+};
+
+// Every thread records into its own buffer, so recording takes no lock; the registry only locks when a thread records for the
+// first time. Buffers are shared with the registry and outlive their threads, e.g. the workers of a replaced thread pool.
+struct ThreadTrace
+{
+    size_t                  threadIndex;
+    uint64_t                allocations;
+    std::vector<TraceEvent> events;
+};
+
+static std::mutex& GetRegistryMutex()
+{
+    static std::mutex registryMutex;
+
+    return registryMutex;
+}
+
+static std::vector<std::shared_ptr<ThreadTrace>>& GetThreadTraces()
+{
+    static std::vector<std::shared_ptr<ThreadTrace>> threadTraces;
+
+    return threadTraces;
+}
+
+static ThreadTrace& GetThreadTrace()
+{
+    static thread_local std::shared_ptr<ThreadTrace> threadTrace;
+
+    if (threadTrace == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(GetRegistryMutex());
+
+        threadTrace.reset(new ThreadTrace{ GetThreadTraces().size(), 0, {} });
+        GetThreadTraces().push_back(threadTrace);
+    }
+
+    return *threadTrace;
+}
+
+// Nanoseconds since the first call, the time base of every event
+static int64_t GetTraceTime()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void EnableInstrumentation(bool enabled)
+{
+    GetTraceTime();
+    instrumentationEnabled.store(enabled);
+}
+
+void ResetInstrumentation()
+{
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+
+    for (const std::shared_ptr<ThreadTrace>& threadTrace : GetThreadTraces())
+    {
+        threadTrace->events.clear();
+        threadTrace->allocations = 0;
+    }
+}
+
+void RecordImageAllocation(size_t)
+{
+    if (IsInstrumentationEnabled())
+        GetThreadTrace().allocations++;
+}
+
+// +--------------------------------------------< TRACE SCOPE >---------------------------------------------+
+
+void TraceScope::Begin()
+{
+    allocations = GetThreadTrace().allocations;
+    begin       = GetTraceTime();
+}
+
+void TraceScope::End()
+{
+    const int64_t end         = GetTraceTime();
+    ThreadTrace&  threadTrace = GetThreadTrace();
+
+    if (outputImage != NULL)
+    {
+        pixels       += outputPixels(outputImage);
+        bytesWritten += outputBytes(outputImage);
+    }
+
+    threadTrace.events.push_back({ name, category, begin, end - begin, pixels, bytesRead, bytesWritten, threadTrace.allocations - allocations });
+}
+
+// +-----------------------------------------------< REPORT >-----------------------------------------------+
+
+std::vector<OperationStatistics> GetOperationStatistics()
+{
+    std::lock_guard<std::mutex>                lock(GetRegistryMutex());
+    std::map<std::string, OperationStatistics> statistics;
+
+    for (const std::shared_ptr<ThreadTrace>& threadTrace : GetThreadTraces())
+        for (const TraceEvent& event : threadTrace->events)
+        {
+            if (std::string(event.category) != "operation")
+                continue;
+
+            OperationStatistics& operation = statistics[event.name];
+
+            operation.name          = event.name;
+            operation.calls        += 1;
+            operation.milliseconds += event.duration / 1e6;
+            operation.pixels       += event.pixels;
+            operation.bytesRead    += event.bytesRead;
+            operation.bytesWritten += event.bytesWritten;
+            operation.allocations  += event.allocations;
+        }
+
+    std::vector<OperationStatistics> operations;
+
+    for (const auto& entry : statistics)
+        operations.push_back(entry.second);
+
+    // Slowest first, which is where the time goes
+    std::sort(operations.begin(), operations.end(), [](const OperationStatistics& left, const OperationStatistics& right) {
+        return left.milliseconds > right.milliseconds;
+    });
+
+    return operations;
+}
+
+void PrintInstrumentationSummary(FILE* stream)
+{
+    fprintf(stream, "%-32s %8s %12s %12s %10s %10s %8s\n", "operation", "calls", "total ms", "mean ms", "MP/s", "GB/s", "allocs");
+
+    for (const OperationStatistics& operation : GetOperationStatistics())
+    {
+        const double seconds = operation.milliseconds / 1e3;
+
+        fprintf(stream, "%-32s %8" PRIu64 " %12.3f %12.3f %10.1f %10.2f %8" PRIu64 "\n", operation.name.c_str(), operation.calls, operation.milliseconds,
+                operation.milliseconds / operation.calls, (seconds > 0.0) ? (operation.pixels / seconds / 1e6) : (0.0),
+                (seconds > 0.0) ? ((operation.bytesRead + operation.bytesWritten) / seconds / 1e9) : (0.0), operation.allocations);
+    }
+
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+
+    fprintf(stream, "\n%-8s %8s %12s\n", "thread", "bands", "busy ms");
+
+    for (const std::shared_ptr<ThreadTrace>& threadTrace : GetThreadTraces())
+    {
+        uint64_t bands = 0;
+        double   busy  = 0.0;
+
+        for (const TraceEvent& event : threadTrace->events)
+            if (std::string(event.category) == "band")
+            {
+                bands += 1;
+                busy  += event.duration / 1e6;
+            }
+
+        if (bands != 0)
+            fprintf(stream, "%-8zu %8" PRIu64 " %12.3f\n", threadTrace->threadIndex, bands, busy);
+    }
+
+    const ImagePoolStatistics pool = GetImagePoolStatistics();
+
+    fprintf(stream, "\nimage pool: %zu acquisitions, %zu hits, %.1f MB peak in use, %.1f MB idle\n", pool.acquisitions, pool.hits,
+            pool.peakBytesInUse / 1048576.0, pool.bytesPooled / 1048576.0);
+}
+
+// Names are string literals chosen by the library, but quotes and backslashes are escaped all the same
+static void WriteJSONString(FILE* fileStream, const char* text)
+{
+    fputc('"', fileStream);
+    for (; *text != '\0'; ++text)
+    {
+        if (*text == '"' || *text == '\\')
+            fputc('\\', fileStream);
+        fputc(*text, fileStream);
+    }
+    fputc('"', fileStream);
+}
+
+bool WriteChromeTrace(const char* fileName)
+{
+    assert(fileName != NULL);
+
+    FILE* fileStream = fopen(fileName, "w");
+
+    if (fileStream == NULL)
+        return false;
+
+    std::lock_guard<std::mutex> lock(GetRegistryMutex());
+
+    bool first = true;
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", fileStream);
+
+    // Complete events ("X") carry their own duration, so nested operations and bands line up without matching begin and end
+    for (const std::shared_ptr<ThreadTrace>& threadTrace : GetThreadTraces())
+    {
+        fprintf(fileStream, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"thread %zu\"}}", (first) ? ("") : (","),
+                threadTrace->threadIndex, threadTrace->threadIndex);
+        first = false;
+
+        for (const TraceEvent& event : threadTrace->events)
+        {
+            fputs(",\n{\"name\":", fileStream);
+            WriteJSONString(fileStream, event.name);
+            fputs(",\"cat\":", fileStream);
+            WriteJSONString(fileStream, event.category);
+            fprintf(fileStream, ",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"pixels\":%" PRIu64 ",\"bytesRead\":%" PRIu64
+                    ",\"bytesWritten\":%" PRIu64 ",\"allocations\":%" PRIu64 "}}",
+                    threadTrace->threadIndex, event.begin / 1e3, event.duration / 1e3, event.pixels, event.bytesRead, event.bytesWritten, event.allocations);
+        }
+    }
+
+    fputs("\n]}\n", fileStream);
+
+    return fclose(fileStream) == 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,134 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+
+// +------------------------------------------< INSTRUMENTATION >-------------------------------------------+
+
+// Instrumentation is off by default. While it is off every hook below costs one relaxed atomic load and records nothing.
+extern std::atomic<bool> instrumentationEnabled;
+
+inline bool IsInstrumentationEnabled()
+{
+    return instrumentationEnabled.load(std::memory_order_relaxed);
+}
+
+void EnableInstrumentation(bool enabled);
+
+// Drops everything recorded so far. Like the reports below it must not be called while an operation is running.
+void ResetInstrumentation();
+
+// +--------------------------------------------< TRACE SCOPE >---------------------------------------------+
+
+// Records one event from construction to destruction on the calling thread: its wall time, the pixels it produced, the image
+// bytes it read and wrote and the image buffers it allocated. name and category must be string literals or otherwise outlive
+// the recording. Every library operation opens one in category "operation" and every parallel band one in category "band".
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, const char* category = "operation")
+        : active(IsInstrumentationEnabled()), name(name), category(category), pixels(0), bytesRead(0), bytesWritten(0), allocations(0), begin(0),
+          outputImage(NULL), outputBytes(NULL), outputPixels(NULL)
+    {
+        if (active)
+            Begin();
+    }
+
+    // Reads inputImage and writes outputImage, whose size is taken when the scope closes, after the operation resized it
+    template <typename InputPixel, typename OutputPixel>
+    TraceScope(const char* name, const ImageBuffer<InputPixel>& inputImage, const ImageBuffer<OutputPixel>& outputImage)
+        : TraceScope(name)
+    {
+        if (!active)
+            return;
+
+        bytesRead         = inputImage.Width() * inputImage.Height() * sizeof(InputPixel);
+        this->outputImage = &outputImage;
+        outputBytes       = &ImageBytes<OutputPixel>;
+        outputPixels      = &ImagePixels<OutputPixel>;
+    }
+
+    ~TraceScope()
+    {
+        if (active)
+            End();
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    // Traffic not described by the images given to the constructor, e.g. a histogram operation that only reads
+    void AddTraffic(uint64_t pixels, uint64_t bytesRead, uint64_t bytesWritten)
+    {
+        this->pixels       += pixels;
+        this->bytesRead    += bytesRead;
+        this->bytesWritten += bytesWritten;
+    }
+
+private:
+    template <typename Pixel>
+    static uint64_t ImageBytes(const void* image)
+    {
+        return static_cast<const ImageBuffer<Pixel>*>(image)->Width() * static_cast<const ImageBuffer<Pixel>*>(image)->Height() * sizeof(Pixel);
+    }
+
+    template <typename Pixel>
+    static uint64_t ImagePixels(const void* image)
+    {
+        return static_cast<const ImageBuffer<Pixel>*>(image)->Width() * static_cast<const ImageBuffer<Pixel>*>(image)->Height();
+    }
+
+    void Begin();
+    void End();
+
+    const bool  active;
+    const char* name;
+    const char* category;
+    uint64_t    pixels;
+    uint64_t    bytesRead;
+    uint64_t    bytesWritten;
+    uint64_t    allocations;
+    int64_t     begin;
+
+    const void* outputImage;
+    uint64_t (*outputBytes)(const void*);
+    uint64_t (*outputPixels)(const void*);
+};
+
+// +-----------------------------------------------< REPORT >-----------------------------------------------+
+
+// Totals of every operation name over all its calls, including calls nested in other operations
+struct OperationStatistics
+{
+    std::string name;
+    uint64_t    calls;
+    double      milliseconds;
+    uint64_t    pixels;
+    uint64_t    bytesRead;
+    uint64_t    bytesWritten;
+    uint64_t    allocations;
+};
+
+std::vector<OperationStatistics> GetOperationStatistics();
+
+// The operation table followed by the busy time of every thread, which shows how evenly the bands were spread
+void PrintInstrumentationSummary(FILE* stream);
+
+// Writes every recorded event in the Chrome trace-event JSON format, one track per thread, for chrome://tracing or Perfetto
+bool WriteChromeTrace(const char* fileName);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,230 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef INTEGRAL_KERNEL_H
+#define INTEGRAL_KERNEL_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+
+#include "CPU Feature.h"
+
+// +-------------------------------------------< INTEGRAL ROW >---------------------------------------------+
+
+// One row of a row-major integral image: output[x] = previous[x] + input[0] + ... + input[x]. previous is NULL for the first row.
+inline void IntegralImageRowScalar(const uint8_t* input, const uint32_t* previous, uint32_t* output, size_t width)
+{
+    uint32_t rowSum = 0;
+
+    for (size_t ix = 0; ix < width; ++ix)
+    {
+        rowSum     += input[ix];
+        output[ix]  = rowSum + ((previous != NULL) ? (previous[ix]) : (0));
+    }
+}
+
+#if defined(SIMD_X86)
+
+SIMD_TARGET_SSE2 inline void IntegralImageRowSSE2(const uint8_t* input, const uint32_t* previous, uint32_t* output, size_t width)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    __m128i       carry = _mm_setzero_si128();
+    size_t        ix    = 0;
+
+    for (; ix + 4 <= width; ix += 4)
+    {
+        int packed;
+
+        memcpy(&packed, input + ix, sizeof(packed));
+
+        __m128i prefix = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+
+        prefix = _mm_add_epi32(prefix, _mm_slli_si128(prefix, 4));
+        prefix = _mm_add_epi32(prefix, _mm_slli_si128(prefix, 8));
+        prefix = _mm_add_epi32(prefix, carry);
+        carry  = _mm_shuffle_epi32(prefix, _MM_SHUFFLE(3, 3, 3, 3));
+
+        if (previous != NULL)
+            prefix = _mm_add_epi32(prefix, _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + ix)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + ix), prefix);
+    }
+
+    uint32_t rowSum = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+
+    for (; ix < width; ++ix)
+    {
+        rowSum     += input[ix];
+        output[ix]  = rowSum + ((previous != NULL) ? (previous[ix]) : (0));
+    }
+}
+
+SIMD_TARGET_AVX2 inline void IntegralImageRowAVX2(const uint8_t* input, const uint32_t* previous, uint32_t* output, size_t width)
+{
+    const __m256i zero     = _mm256_setzero_si256();
+    const __m256i lowLast  = _mm256_set1_epi32(3);
+    const __m256i highLast = _mm256_set1_epi32(7);
+    __m256i       carry    = _mm256_setzero_si256();
+    size_t        ix       = 0;
+
+    for (; ix + 8 <= width; ix += 8)
+    {
+        __m256i prefix = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + ix)));
+
+        // Prefix sums inside each 128-bit lane, then the low lane's total is carried into the high lane
+        prefix = _mm256_add_epi32(prefix, _mm256_slli_si256(prefix, 4));
+        prefix = _mm256_add_epi32(prefix, _mm256_slli_si256(prefix, 8));
+        prefix = _mm256_add_epi32(prefix, _mm256_blend_epi32(zero, _mm256_permutevar8x32_epi32(prefix, lowLast), 0xF0));
+        prefix = _mm256_add_epi32(prefix, carry);
+        carry  = _mm256_permutevar8x32_epi32(prefix, highLast);
+
+        if (previous != NULL)
+            prefix = _mm256_add_epi32(prefix, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + ix)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + ix), prefix);
+    }
+
+    uint32_t rowSum = static_cast<uint32_t>(_mm256_cvtsi256_si32(carry));
+
+    for (; ix < width; ++ix)
+    {
+        rowSum     += input[ix];
+        output[ix]  = rowSum + ((previous != NULL) ? (previous[ix]) : (0));
+    }
+}
+
+#endif
+
+inline void IntegralImageRow(const uint8_t* input, const uint32_t* previous, uint32_t* output, size_t width)
+{
+    assert(input  != NULL);
+    assert(output != NULL);
+
+    switch (GetSIMDLevel())
+    {
+#if defined(SIMD_X86)
+    case SIMDLevel::AVX2:
+        IntegralImageRowAVX2(input, previous, output, width);
+        break;
+    case SIMDLevel::SSE2:
+        IntegralImageRowSSE2(input, previous, output, width);
+        break;
+#endif
+    default:
+        IntegralImageRowScalar(input, previous, output, width);
+        break;
+    }
+}
+
+// +-----------------------------------------< INTEGRAL BOX ROW >-------------------------------------------+
+
+// Interior box averages of one output row, where every window has a full row above it and a full column to its left.
+// top and bottom point at the integral rows just above and at the bottom of the window, offset to the column left of the first
+// window, so output[i] = (bottom[i + wsize] - bottom[i] - top[i + wsize] + top[i]) / area without any bounds checks.
+inline void IntegralBoxAverageRowScalar(const uint32_t* top, const uint32_t* bottom, uint8_t* output, size_t count, size_t wsize, uint32_t area)
+{
+    for (size_t ix = 0; ix < count; ++ix)
+        output[ix] = static_cast<uint8_t>((bottom[ix + wsize] - bottom[ix] - top[ix + wsize] + top[ix]) / area);
+}
+
+#if defined(SIMD_X86)
+
+// The quotient goes through double precision: (sum + 0.5) / area lies at least 0.5 / area away from the next integer, far beyond
+// the rounding error, so truncation reproduces the integer division exactly. Sums are unsigned and are biased by 2^31 to convert.
+SIMD_TARGET_SSE2 inline __m128i IntegralBoxQuotientSSE2(__m128i sum, __m128d inverseArea)
+{
+    const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000U));
+    const __m128d offset  = _mm_set1_pd(2147483648.0 + 0.5);
+    const __m128i biased  = _mm_xor_si128(sum, signBit);
+
+    const __m128i low  = _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_cvtepi32_pd(biased), offset), inverseArea));
+    const __m128i high = _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(biased, _MM_SHUFFLE(1, 0, 3, 2))), offset), inverseArea));
+
+    return _mm_unpacklo_epi64(low, high);
+}
+
+SIMD_TARGET_SSE2 inline void IntegralBoxAverageRowSSE2(const uint32_t* top, const uint32_t* bottom, uint8_t* output, size_t count, size_t wsize, uint32_t area)
+{
+    const __m128d inverseArea = _mm_set1_pd(1.0 / area);
+    size_t        ix          = 0;
+
+    for (; ix + 8 <= count; ix += 8)
+    {
+        __m128i quotients[2];
+
+        for (int half = 0; half < 2; ++half)
+        {
+            const size_t offset = ix + 4 * half;
+            __m128i      sum    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + offset + wsize));
+
+            sum = _mm_sub_epi32(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + offset)));
+            sum = _mm_sub_epi32(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + offset + wsize)));
+            sum = _mm_add_epi32(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + offset)));
+
+            quotients[half] = IntegralBoxQuotientSSE2(sum, inverseArea);
+        }
+
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(quotients[0], quotients[1]), _mm_setzero_si128());
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + ix), packed);
+    }
+
+    IntegralBoxAverageRowScalar(top + ix, bottom + ix, output + ix, count - ix, wsize, area);
+}
+
+SIMD_TARGET_AVX2 inline void IntegralBoxAverageRowAVX2(const uint32_t* top, const uint32_t* bottom, uint8_t* output, size_t count, size_t wsize, uint32_t area)
+{
+    const __m256i signBit     = _mm256_set1_epi32(static_cast<int>(0x80000000U));
+    const __m256d offset      = _mm256_set1_pd(2147483648.0 + 0.5);
+    const __m256d inverseArea = _mm256_set1_pd(1.0 / area);
+    size_t        ix          = 0;
+
+    for (; ix + 8 <= count; ix += 8)
+    {
+        __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + ix + wsize));
+
+        sum = _mm256_sub_epi32(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + ix)));
+        sum = _mm256_sub_epi32(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + ix + wsize)));
+        sum = _mm256_add_epi32(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + ix)));
+        sum = _mm256_xor_si256(sum, signBit);
+
+        const __m128i low  = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(sum)), offset), inverseArea));
+        const __m128i high = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(sum, 1)), offset), inverseArea));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + ix), _mm_packus_epi16(_mm_packs_epi32(low, high), _mm_setzero_si128()));
+    }
+
+    IntegralBoxAverageRowScalar(top + ix, bottom + ix, output + ix, count - ix, wsize, area);
+}
+
+#endif
+
+inline void IntegralBoxAverageRow(const uint32_t* top, const uint32_t* bottom, uint8_t* output, size_t count, size_t wsize, uint32_t area)
+{
+    assert(top    != NULL);
+    assert(bottom != NULL);
+    assert(output != NULL);
+    assert(area   != 0);
+
+    switch (GetSIMDLevel())
+    {
+#if defined(SIMD_X86)
+    case SIMDLevel::AVX2:
+        IntegralBoxAverageRowAVX2(top, bottom, output, count, wsize, area);
+        break;
+    case SIMDLevel::SSE2:
+        IntegralBoxAverageRowSSE2(top, bottom, output, count, wsize, area);
+        break;
+#endif
+    default:
+        IntegralBoxAverageRowScalar(top, bottom, output, count, wsize, area);
+        break;
+    }
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -8,90 +8,131 @@
 
 #include <cassert>
 #include <cinttypes>
-#include <cstdio>
+#include <cstring>
+#include <vector>
 
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
-
-typedef uint8_t  byte_t;
-typedef uint32_t lbyte_t;
-
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
-
-static const size_t WIDTH  = 512;
-static const size_t HEIGHT = 512;
-
-byte_t inputImage[WIDTH * HEIGHT];
-byte_t zeroInterpolatorImage[4 * WIDTH * HEIGHT];
-byte_t firstInterpolatorImage[4 * WIDTH * HEIGHT];
+#include "Instrumentation.h"
+#include "Interpolator.h"
+#include "Parallel Executor.h"
 
 // +--------------------------------------------< INTERPOLATOR >--------------------------------------------+
 
-byte_t* ZeroOrderInterpolator(byte_t* inputImage, byte_t* outputImage, const int magnification)
+template <typename Pixel>
+ImageBuffer<Pixel>& ZeroOrderInterpolator(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int magnification)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("ZeroOrderInterpolator", inputImage, outputImage);
 
-    for (int iy = 0; iy < magnification * HEIGHT; ++iy)
-        for (int ix = 0; ix < magnification * WIDTH; ++ix)
-            outputImage[iy * (magnification * WIDTH) + ix] = inputImage[(iy / magnification) * WIDTH + (ix / magnification)];
+    assert(&inputImage != &outputImage);
+    assert(magnification > 0);
 
-    return outputImage;
-}
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
 
-byte_t* FirstOrderInterpolator(byte_t* inputImage, byte_t* outputImage)
-{
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    outputImage.Resize(magnification * width, magnification * height);
 
-    lbyte_t interimData;
+    // The source column of every output column is tabulated once instead of divided out per pixel, and the copies of a row
+    // after the first are plain row copies
+    std::vector<uint32_t> sourceColumns(magnification * width);
 
-    for (int iy = 0; iy < 2 * HEIGHT; ++iy)
-        for (int ix = 0; ix < 2 * WIDTH; ++ix)
-            outputImage[iy * (2 * WIDTH) + ix] = inputImage[(iy / 2) * WIDTH + (ix / 2)];
+    for (size_t ix = 0; ix < magnification * width; ++ix)
+        sourceColumns[ix] = static_cast<uint32_t>(ix / magnification);
 
-    for (int iy = 0; iy < 2 * HEIGHT; iy += 2)
-        for (int ix = 1; ix < 2 * WIDTH; ix += 2)
+    ParallelForRows(0, magnification * height, [&](size_t bandBegin, size_t bandEnd) {
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
         {
-            interimData = outputImage[iy * (2 * WIDTH) + (ix - 1)] + outputImage[iy * (2 * WIDTH) + (ix + 1)];
-            outputImage[iy * (2 * WIDTH) + ix] = static_cast<byte_t>(interimData / 2.0F + 0.5F);
-        }
+            Pixel* outputRow = outputImage.Row(iy);
 
-    for (int iy = 1; iy < 2 * HEIGHT; iy += 2)
-        for (int ix = 0; ix < 2 * WIDTH; ix += 2)
-        {
-            interimData = outputImage[(iy - 1) * (2 * WIDTH) + ix] + outputImage[(iy + 1) * (2 * WIDTH) + ix];
-            outputImage[iy * (2 * WIDTH) + ix] = static_cast<byte_t>(interimData / 2.0F + 0.5F);
+            if (iy % magnification != 0 && iy != bandBegin)
+            {
+                memcpy(outputRow, outputImage.Row(iy - 1), magnification * width * sizeof(Pixel));
+                continue;
+            }
+
+            const Pixel* inputRow = inputImage.Row(iy / magnification);
+
+            for (size_t ix = 0; ix < magnification * width; ++ix)
+                outputRow[ix] = inputRow[sourceColumns[ix]];
         }
+    });
 
     return outputImage;
 }
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
+template Image&     ZeroOrderInterpolator(const Image&, Image&, const int);
+template WideImage& ZeroOrderInterpolator(const WideImage&, WideImage&, const int);
+template RGBImage&  ZeroOrderInterpolator(const RGBImage&, RGBImage&, const int);
+template RGBAImage& ZeroOrderInterpolator(const RGBAImage&, RGBAImage&, const int);
 
-int main(void)
+template <typename Pixel>
+ImageBuffer<Pixel>& FirstOrderInterpolator(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage)
 {
-    static const char* INPUT_RAW_FILE_NAME                     = "Lena.raw";
-    static const char* OUTPUT_ZERO_INTERPOLATOR_RAW_FILE_NAME  = "Lena_ZeroInterpolator.raw";
-    static const char* OUTPUT_FIRST_INTERPOLATOR_RAW_FILE_NAME = "Lena_FirstInterpolator.raw";
+    TraceScope trace("FirstOrderInterpolator", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
 
-    FILE* fileStream;
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
 
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    assert(&inputImage != &outputImage);
 
-    ZeroOrderInterpolator(inputImage, zeroInterpolatorImage, 2);
-    FirstOrderInterpolator(inputImage, firstInterpolatorImage);
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
 
-    fileStream = fopen(OUTPUT_ZERO_INTERPOLATOR_RAW_FILE_NAME, "w+b");
-    fwrite(zeroInterpolatorImage, sizeof(zeroInterpolatorImage), 1, fileStream);
-    fclose(fileStream);
+    outputImage.Resize(2 * width, 2 * height);
 
-    fileStream = fopen(OUTPUT_FIRST_INTERPOLATOR_RAW_FILE_NAME, "w+b");
-    fwrite(firstInterpolatorImage, sizeof(firstInterpolatorImage), 1, fileStream);
-    fclose(fileStream);
+    // Each pass reads rows written by the previous one, so the passes run one after another and only rows within a pass are split
+    ParallelForRows(0, 2 * height, [&](size_t bandBegin, size_t bandEnd) {
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const Pixel* inputRow  = inputImage.Row(iy / 2);
+            Pixel*       outputRow = outputImage.Row(iy);
 
-    return 0;
+            for (size_t ix = 0; ix < 2 * width; ++ix)
+                outputRow[ix] = inputRow[ix / 2];
+        }
+    });
+
+    // The last column and the last row have no right or lower neighbour, so they keep their replicated value instead of reading
+    // past the end of the row or the image. Every channel is averaged with the same channel of the neighbours.
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        lbyte_t interimData;
+
+        for (size_t iy = 2 * bandBegin; iy < 2 * bandEnd; iy += 2)
+        {
+            Sample* outputRow = SampleRow(outputImage, iy);
+
+            for (size_t ix = 1; ix + 1 < 2 * width; ix += 2)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                {
+                    interimData                        = outputRow[(ix - 1) * CHANNELS + channel] + outputRow[(ix + 1) * CHANNELS + channel];
+                    outputRow[ix * CHANNELS + channel] = static_cast<Sample>(interimData / 2.0F + 0.5F);
+                }
+        }
+    });
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        lbyte_t interimData;
+
+        for (size_t iy = 2 * bandBegin + 1; iy < 2 * bandEnd && iy + 1 < 2 * height; iy += 2)
+        {
+            const Sample* upperRow  = SampleRow(outputImage, iy - 1);
+            const Sample* lowerRow  = SampleRow(outputImage, iy + 1);
+            Sample*       outputRow = SampleRow(outputImage, iy);
+
+            for (size_t ix = 0; ix < 2 * width; ix += 2)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                {
+                    interimData                        = upperRow[ix * CHANNELS + channel] + lowerRow[ix * CHANNELS + channel];
+                    outputRow[ix * CHANNELS + channel] = static_cast<Sample>(interimData / 2.0F + 0.5F);
+                }
+        }
+    });
+
+    return outputImage;
 }
 
+template Image&     FirstOrderInterpolator(const Image&, Image&);
+template WideImage& FirstOrderInterpolator(const WideImage&, WideImage&);
+template RGBImage&  FirstOrderInterpolator(const RGBImage&, RGBImage&);
+template RGBAImage& FirstOrderInterpolator(const RGBAImage&, RGBAImage&);
+
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,20 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef INTERPOLATOR_H
+#define INTERPOLATOR_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Image.h"
+
+// +--------------------------------------------< INTERPOLATOR >--------------------------------------------+
+
+template <typename Pixel>
+ImageBuffer<Pixel>& ZeroOrderInterpolator(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int magnification);
+
+template <typename Pixel>
+ImageBuffer<Pixel>& FirstOrderInterpolator(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,223 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cassert>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "Mapped Image.h"
+
+// +--------------------------------------------< MAPPED IMAGE >--------------------------------------------+
+
+MappedImage::MappedImage()
+    : mapping(NULL), size(0), writable(false)
+#if defined(_WIN32)
+    , fileHandle(INVALID_HANDLE_VALUE), mappingHandle(NULL)
+#else
+    , fileDescriptor(-1)
+#endif
+{
+}
+
+MappedImage::~MappedImage()
+{
+    Close();
+}
+
+bool MappedImage::OpenRead(const char* fileName, size_t width, size_t height)
+{
+    return Map(fileName, width, height, false);
+}
+
+bool MappedImage::Create(const char* fileName, size_t width, size_t height)
+{
+    return Map(fileName, width, height, true);
+}
+
+Image MappedImage::GetRows(size_t rowBegin, size_t rowEnd) const
+{
+    assert(rowBegin <= rowEnd && rowEnd <= image.Height());
+
+    // A read-only mapping still yields a mutable Image, which callers only ever pass on as const
+    return Image(mapping + rowBegin * image.Width(), image.Width(), rowEnd - rowBegin, image.Width());
+}
+
+#if defined(_WIN32)
+
+bool MappedImage::Map(const char* fileName, size_t width, size_t height, bool writable)
+{
+    assert(fileName != NULL);
+
+    Close();
+
+    const size_t size = width * height;
+
+    if (size == 0)
+        return false;
+
+    fileHandle = CreateFileA(fileName, (writable) ? (GENERIC_READ | GENERIC_WRITE) : (GENERIC_READ), FILE_SHARE_READ, NULL,
+                             (writable) ? (CREATE_ALWAYS) : (OPEN_EXISTING), FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+
+    if (!writable && (!GetFileSizeEx(fileHandle, &fileSize) || static_cast<unsigned long long>(fileSize.QuadPart) < size))
+    {
+        Close();
+
+        return false;
+    }
+
+    const unsigned long long mappingSize = size;
+
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, (writable) ? (PAGE_READWRITE) : (PAGE_READONLY),
+                                       static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), NULL);
+    if (mappingHandle != NULL)
+        mapping = static_cast<byte_t*>(MapViewOfFile(mappingHandle, (writable) ? (FILE_MAP_WRITE) : (FILE_MAP_READ), 0, 0, size));
+
+    if (mapping == NULL)
+    {
+        Close();
+
+        return false;
+    }
+
+    this->size     = size;
+    this->writable = writable;
+    image          = Image(mapping, width, height, width);
+
+    return true;
+}
+
+void MappedImage::Close()
+{
+    if (mapping != NULL)
+    {
+        if (writable)
+            FlushViewOfFile(mapping, 0);
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != NULL)
+        CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+
+    image         = Image();
+    mapping       = NULL;
+    size          = 0;
+    writable      = false;
+    fileHandle    = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+}
+
+void MappedImage::Release(size_t rowBegin, size_t rowEnd)
+{
+    assert(rowBegin <= rowEnd && rowEnd <= image.Height());
+
+    // Unlocking pages that were never locked evicts them from the working set, which is the closest Windows has to MADV_DONTNEED
+    if (mapping != NULL && rowBegin < rowEnd)
+        VirtualUnlock(mapping + rowBegin * image.Width(), (rowEnd - rowBegin) * image.Width());
+}
+
+#else
+
+bool MappedImage::Map(const char* fileName, size_t width, size_t height, bool writable)
+{
+    assert(fileName != NULL);
+
+    Close();
+
+    const size_t size = width * height;
+
+    if (size == 0)
+        return false;
+
+    fileDescriptor = (writable) ? (open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644)) : (open(fileName, O_RDONLY));
+
+    if (fileDescriptor < 0)
+        return false;
+
+    struct stat fileStatus;
+
+    if ((writable && ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) ||
+        (!writable && (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<size_t>(fileStatus.st_size) < size)))
+    {
+        Close();
+
+        return false;
+    }
+
+    void* address = mmap(NULL, size, (writable) ? (PROT_READ | PROT_WRITE) : (PROT_READ), MAP_SHARED, fileDescriptor, 0);
+
+    if (address == MAP_FAILED)
+    {
+        Close();
+
+        return false;
+    }
+
+    // Strips walk the file front to back, so aggressive read-ahead pays off and pages behind the strip can go early
+    madvise(address, size, MADV_SEQUENTIAL);
+
+    this->mapping  = static_cast<byte_t*>(address);
+    this->size     = size;
+    this->writable = writable;
+    image          = Image(mapping, width, height, width);
+
+    return true;
+}
+
+void MappedImage::Close()
+{
+    if (mapping != NULL)
+        munmap(mapping, size);
+    if (fileDescriptor >= 0)
+        close(fileDescriptor);
+
+    image          = Image();
+    mapping        = NULL;
+    size           = 0;
+    writable       = false;
+    fileDescriptor = -1;
+}
+
+void MappedImage::Release(size_t rowBegin, size_t rowEnd)
+{
+    assert(rowBegin <= rowEnd && rowEnd <= image.Height());
+
+    if (mapping == NULL)
+        return;
+
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin    = reinterpret_cast<uintptr_t>(mapping + rowBegin * image.Width()) & ~(pageSize - 1);
+    const uintptr_t end      = reinterpret_cast<uintptr_t>(mapping + rowEnd * image.Width());
+
+    if (begin >= end)
+        return;
+
+    // Dirty pages of a shared mapping survive MADV_DONTNEED in the page cache, starting their write-back keeps it from piling up
+    if (writable)
+        msync(reinterpret_cast<void*>(begin), end - begin, MS_ASYNC);
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
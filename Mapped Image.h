@@ -0,0 +1,74 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef MAPPED_IMAGE_H
+#define MAPPED_IMAGE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstddef>
+
+#include "Image.h"
+
+// +--------------------------------------------< MAPPED IMAGE >--------------------------------------------+
+
+// A raw file mapped into memory and seen as a borrowed Image whose stride equals its width. The kernel pages rows in on demand,
+// so a file far larger than memory can be walked strip by strip; Release hands the pages of finished rows back to keep the
+// resident set bounded. Written pages reach the file through the shared mapping, at the latest when the image is closed.
+class MappedImage
+{
+public:
+    MappedImage();
+    ~MappedImage();
+
+    MappedImage(const MappedImage&)            = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    // Maps an existing raw file of at least width x height pixels read-only
+    bool OpenRead(const char* fileName, size_t width, size_t height);
+
+    // Creates or truncates a raw file of exactly width x height pixels and maps it read-write
+    bool Create(const char* fileName, size_t width, size_t height);
+
+    void Close();
+
+    bool IsOpen() const
+    {
+        return mapping != NULL;
+    }
+
+    bool IsWritable() const
+    {
+        return writable;
+    }
+
+    const Image& GetImage() const
+    {
+        return image;
+    }
+
+    // A borrowed view of rows rowBegin ... rowEnd - 1 sharing the mapped pixels, which may only be written on a writable mapping
+    Image GetRows(size_t rowBegin, size_t rowEnd) const;
+
+    // Drops the pages holding rows rowBegin ... rowEnd - 1 from the resident set. Written pages are scheduled for write-back and
+    // stay in the page cache, so nothing is lost: a row touched again, including a neighbour sharing a page, is simply paged back in.
+    void Release(size_t rowBegin, size_t rowEnd);
+
+private:
+    Image   image;
+    byte_t* mapping;
+    size_t  size;
+    bool    writable;
+
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    bool Map(const char* fileName, size_t width, size_t height, bool writable);
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
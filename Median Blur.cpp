@@ -9,106 +9,468 @@
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
-#include <cstdio>
-#include <cstdlib>
+#include <cmath>
 #include <cstring>
-#include <ctime>
 #include <vector>
 
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Median Blur.h"
+#include "Parallel Executor.h"
 
-typedef uint8_t byte_t;
-
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
+// +------------------------------------------< SALT AND PEPPER >-------------------------------------------+
 
-static const size_t WIDTH  = 512;
-static const size_t HEIGHT = 512;
+// SplitMix64: one 64-bit counter of state and a few multiplies per number, so the seed alone fixes the noise on every platform
+static uint64_t NextRandom(uint64_t& state)
+{
+    uint64_t random = (state += 0x9E3779B97F4A7C15ULL);
 
-byte_t inputImage[WIDTH * HEIGHT];
-byte_t outputImage[WIDTH * HEIGHT];
+    random = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    random = (random ^ (random >> 27)) * 0x94D049BB133111EBULL;
 
-// +------------------------------------------< SALT AND PEPPER >-------------------------------------------+
+    return random ^ (random >> 31);
+}
 
-byte_t* CreateSaltAndPepperNoise(byte_t* inputImage, byte_t* outputImage, float ratio)
+Image& CreateSaltAndPepperNoise(const Image& inputImage, Image& outputImage, float ratio, uint64_t seed)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("CreateSaltAndPepperNoise", inputImage, outputImage);
+
     assert(ratio >= 0.0 && ratio <= 1.0);
 
-    srand(static_cast<unsigned int>(time(NULL)));
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
+    const size_t pixels = width * height;
+    const size_t count  = static_cast<size_t>(std::ceil(pixels * static_cast<double>(ratio)));
+    uint64_t     state  = seed;
 
-    for (int index = 0; index < WIDTH * HEIGHT * ratio; ++index)
-        outputImage[(rand() % HEIGHT) * WIDTH + (rand() % WIDTH)] = rand() % 2 * 255;
+    CopyImage(inputImage, outputImage);
+
+    // The lowest bit picks salt or pepper and the rest the pixel, hit more than once now and then just like before
+    for (size_t index = 0; index < count; ++index)
+    {
+        const uint64_t random = NextRandom(state);
+        const size_t   pixel  = static_cast<size_t>((random >> 1) % pixels);
+
+        outputImage(pixel % width, pixel / width) = (random & 1) * 255;
+    }
 
     return outputImage;
 }
 
 // +--------------------------------------------< MEDIAN BLUR >---------------------------------------------+
 
-byte_t* SeparableMedianBlur(byte_t* inputImage, byte_t* outputImage, const int wsize)
+template <typename Pixel>
+ImageBuffer<Pixel>& SeparableMedianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int wsize, BorderMode border,
+                                        PixelSample<Pixel> borderValue)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("SeparableMedianBlur", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
+
+    static const int CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(&inputImage != &outputImage);
     assert(wsize % 2   == 1);
 
-    byte_t*             interimImage = new byte_t[WIDTH * HEIGHT];
-    std::vector<byte_t> filter(wsize, 0);
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
 
-    memcpy(interimImage, inputImage, WIDTH * HEIGHT);
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+    ScratchImage<Pixel> interimImage(inputImage);
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
+    const auto filterBorder = [&](const ImageBuffer<Pixel>& borderImage, ImageBuffer<Pixel>& filteredImage) {
+        SeparableMedianBlur(borderImage, filteredImage, wsize);
+    };
+
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
+
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+
+    // Each channel takes the median of its own samples, which lie CHANNELS apart along a row
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        std::vector<Sample> filter(wsize, 0);
+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
         {
-            for (int iw = -wsize / 2; iw <= wsize / 2; ++iw)
-                filter[iw + wsize / 2] = inputImage[iy * WIDTH + (ix + iw)];
-            sort(filter.begin(), filter.end());
+            const Sample* inputRow   = SampleRow(inputImage, iy);
+            Sample*       interimRow = SampleRow(interimImage, iy);
+
+            for (int index = wsize / 2 * CHANNELS; index < (width - wsize / 2) * CHANNELS; ++index)
+            {
+                for (int iw = -wsize / 2; iw <= wsize / 2; ++iw)
+                    filter[iw + wsize / 2] = inputRow[index + iw * CHANNELS];
+                sort(filter.begin(), filter.end());
 
-            interimImage[iy * WIDTH + ix] = filter[wsize / 2];
+                interimRow[index] = filter[wsize / 2];
+            }
         }
+    });
 
-    for (int ix = 0; ix < WIDTH; ++ix)
-        for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        std::vector<Sample> filter(wsize, 0);
+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
         {
-            for (int iw = -wsize / 2; iw <= wsize / 2; ++iw)
-                filter[iw + wsize / 2] = interimImage[(iy + iw) * WIDTH + ix];
-            sort(filter.begin(), filter.end());
+            Sample* outputRow = SampleRow(outputImage, iy);
+
+            for (int index = 0; index < width * CHANNELS; ++index)
+            {
+                for (int iw = -wsize / 2; iw <= wsize / 2; ++iw)
+                    filter[iw + wsize / 2] = SampleRow(interimImage, iy + iw)[index];
+                sort(filter.begin(), filter.end());
 
-            outputImage[iy * WIDTH + ix] = filter[wsize / 2];
+                outputRow[index] = filter[wsize / 2];
+            }
         }
+    });
 
-    delete[] interimImage;
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+}
 
-    return outputImage;
+template Image&     SeparableMedianBlur(const Image&, Image&, const int, BorderMode, byte_t);
+template WideImage& SeparableMedianBlur(const WideImage&, WideImage&, const int, BorderMode, wbyte_t);
+template RGBImage&  SeparableMedianBlur(const RGBImage&, RGBImage&, const int, BorderMode, byte_t);
+template RGBAImage& SeparableMedianBlur(const RGBAImage&, RGBAImage&, const int, BorderMode, byte_t);
+
+// +---------------------------------------< HISTOGRAM MEDIAN BLUR >----------------------------------------+
+
+struct MedianHistogram
+{
+    uint16_t bins[256];
+    int      median;
+    int      belowMedian;
+};
+
+static inline void ResetMedianHistogram(MedianHistogram& histogram)
+{
+    memset(histogram.bins, 0, sizeof(histogram.bins));
+    histogram.median      = 0;
+    histogram.belowMedian = 0;
+}
+
+static inline void InsertMedianHistogram(MedianHistogram& histogram, byte_t brightness)
+{
+    histogram.bins[brightness]++;
+    if (brightness < histogram.median)
+        histogram.belowMedian++;
+}
+
+static inline void RemoveMedianHistogram(MedianHistogram& histogram, byte_t brightness)
+{
+    histogram.bins[brightness]--;
+    if (brightness < histogram.median)
+        histogram.belowMedian--;
+}
+
+static inline byte_t SeekMedianHistogram(MedianHistogram& histogram, const int rank)
+{
+    // Walks the median from its previous position, so the cost depends on how far the median moved rather than on the window size
+    while (histogram.belowMedian > rank)
+        histogram.belowMedian -= histogram.bins[--histogram.median];
+    while (histogram.belowMedian + histogram.bins[histogram.median] <= rank)
+        histogram.belowMedian += histogram.bins[histogram.median++];
+
+    return static_cast<byte_t>(histogram.median);
+}
+
+Image& SeparableHistogramMedianBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border, byte_t borderValue)
+{
+    TraceScope trace("SeparableHistogramMedianBlur", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
+    assert(wsize % 2   == 1);
+    assert(wsize       <= 65535);
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+
+    ScratchImage<byte_t> interimImage(inputImage);
+
+    const auto filterBorder = [&](const Image& borderImage, Image& filteredImage) {
+        SeparableHistogramMedianBlur(borderImage, filteredImage, wsize);
+    };
+
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
+
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        MedianHistogram rowHistogram;
+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+        {
+            ResetMedianHistogram(rowHistogram);
+            for (int iw = 0; iw < wsize - 1; ++iw)
+                InsertMedianHistogram(rowHistogram, inputImage(iw, iy));
+
+            for (int ix = wsize / 2; ix < width - wsize / 2; ++ix)
+            {
+                InsertMedianHistogram(rowHistogram, inputImage(ix + wsize / 2, iy));
+                interimImage(ix, iy) = SeekMedianHistogram(rowHistogram, wsize / 2);
+                RemoveMedianHistogram(rowHistogram, inputImage(ix - wsize / 2, iy));
+            }
+        }
+    });
+
+    // The vertical pass keeps one running histogram per column and walks the image row by row instead of striding down each column.
+    // Every band primes its own column histograms from the wsize - 1 halo rows around its first row.
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<MedianHistogram> columnHistograms(width);
+
+        for (int ix = 0; ix < width; ++ix)
+            ResetMedianHistogram(columnHistograms[ix]);
+        for (int iy = static_cast<int>(bandBegin) - wsize / 2; iy < static_cast<int>(bandBegin) + wsize / 2; ++iy)
+            for (int ix = 0; ix < width; ++ix)
+                InsertMedianHistogram(columnHistograms[ix], interimImage(ix, iy));
+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+            for (int ix = 0; ix < width; ++ix)
+            {
+                InsertMedianHistogram(columnHistograms[ix], interimImage(ix, iy + wsize / 2));
+                outputImage(ix, iy) = SeekMedianHistogram(columnHistograms[ix], wsize / 2);
+                RemoveMedianHistogram(columnHistograms[ix], interimImage(ix, iy - wsize / 2));
+            }
+    }, 4 * wsize);
+
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
 }
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
+Image& HistogramMedianBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border, byte_t borderValue)
+{
+    TraceScope trace("HistogramMedianBlur", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
+    assert(wsize % 2   == 1);
+    assert(wsize       <= 255);
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+    const int rank   = wsize * wsize / 2;
+
+    const auto filterBorder = [&](const Image& borderImage, Image& filteredImage) {
+        HistogramMedianBlur(borderImage, filteredImage, wsize);
+    };
+
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
+
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+
+    // Perreault and Hebert: one 256-bin histogram per column plus a coarse 16-bin level for the kernel, so each output pixel costs
+    // one coarse column add, one coarse column subtract and two short scans regardless of the window size. The fine kernel bins are
+    // updated lazily: each group of 16 remembers the column its counts belong to and catches up only when the median falls into
+    // it, from the columns that entered and left since then or, past half a window of them, by counting the window afresh.
+    // Smooth images keep their medians within a few groups, so most columns never touch the fine bins of the kernel at all. Every
+    // band keeps its own column histograms and primes them from the wsize - 1 halo rows around its first row.
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<uint16_t> histogramBuffer(width * 256);
+        ScratchBuffer<uint16_t> coarseBuffer(width * 16);
+        uint16_t*               columnHistograms = histogramBuffer.Data();
+        uint16_t*               columnCoarse     = coarseBuffer.Data();
+        uint16_t                kernelFine[256];
+        uint16_t                kernelCoarse[16];
+        int                     fineColumns[16];
+
+        // Brings the fine bins of coarse group up to date for the window centred on column ix
+        const auto refreshFine = [&](int coarse, int ix) {
+            uint16_t* fine = kernelFine + coarse * 16;
+
+            if (2 * (ix - fineColumns[coarse]) > wsize)
+            {
+                memset(fine, 0, 16 * sizeof(uint16_t));
+                for (int column = ix - wsize / 2; column <= ix + wsize / 2; ++column)
+                    for (int bin = 0; bin < 16; ++bin)
+                        fine[bin] += columnHistograms[column * 256 + coarse * 16 + bin];
+            }
+            else
+                for (int column = fineColumns[coarse] + 1; column <= ix; ++column)
+                {
+                    const uint16_t* incoming = columnHistograms + (column + wsize / 2) * 256 + coarse * 16;
+                    const uint16_t* outgoing = columnHistograms + (column - wsize / 2 - 1) * 256 + coarse * 16;
+
+                    for (int bin = 0; bin < 16; ++bin)
+                        fine[bin] += incoming[bin] - outgoing[bin];
+                }
+
+            fineColumns[coarse] = ix;
+        };
+
+        memset(columnHistograms, 0, width * 256 * sizeof(uint16_t));
+        memset(columnCoarse, 0, width * 16 * sizeof(uint16_t));
+        for (int iy = static_cast<int>(bandBegin) - wsize / 2; iy < static_cast<int>(bandBegin) + wsize / 2; ++iy)
+            for (int ix = 0; ix < width; ++ix)
+            {
+                columnHistograms[ix * 256 + inputImage(ix, iy)]++;
+                columnCoarse[ix * 16 + inputImage(ix, iy) / 16]++;
+            }
+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+        {
+            for (int ix = 0; ix < width; ++ix)
+            {
+                columnHistograms[ix * 256 + inputImage(ix, iy + wsize / 2)]++;
+                columnCoarse[ix * 16 + inputImage(ix, iy + wsize / 2) / 16]++;
+            }
+
+            // Every group starts the row a full window behind the first pixel, so its first refresh counts the window afresh
+            memset(kernelCoarse, 0, sizeof(kernelCoarse));
+            for (int coarse = 0; coarse < 16; ++coarse)
+                fineColumns[coarse] = wsize / 2 - wsize;
+            for (int iw = 0; iw < wsize - 1; ++iw)
+                for (int coarse = 0; coarse < 16; ++coarse)
+                    kernelCoarse[coarse] += columnCoarse[iw * 16 + coarse];
+
+            for (int ix = wsize / 2; ix < width - wsize / 2; ++ix)
+            {
+                const uint16_t* incomingCoarse = columnCoarse + (ix + wsize / 2) * 16;
+
+                for (int coarse = 0; coarse < 16; ++coarse)
+                    kernelCoarse[coarse] += incomingCoarse[coarse];
+
+                int medianCoarse = 0;
+                int count        = 0;
+
+                while (count + kernelCoarse[medianCoarse] <= rank)
+                    count += kernelCoarse[medianCoarse++];
+
+                refreshFine(medianCoarse, ix);
+
+                int median = medianCoarse * 16;
+
+                while (count + kernelFine[median] <= rank)
+                    count += kernelFine[median++];
+
+                outputImage(ix, iy) = static_cast<byte_t>(median);
 
-int main(void)
+                const uint16_t* outgoingCoarse = columnCoarse + (ix - wsize / 2) * 16;
+
+                for (int coarse = 0; coarse < 16; ++coarse)
+                    kernelCoarse[coarse] -= outgoingCoarse[coarse];
+            }
+
+            for (int ix = 0; ix < width; ++ix)
+            {
+                columnHistograms[ix * 256 + inputImage(ix, iy - wsize / 2)]--;
+                columnCoarse[ix * 16 + inputImage(ix, iy - wsize / 2) / 16]--;
+            }
+        }
+    }, 4 * wsize);
+
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+}
+
+// +----------------------------------------< ADAPTIVE MEDIAN BLUR >----------------------------------------+
+
+template <typename Pixel>
+ImageBuffer<Pixel>& AdaptiveMedianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int maxWsize, BorderMode border,
+                                       PixelSample<Pixel> borderValue)
 {
-    static const char* INPUT_RAW_FILE_NAME                   = "Lena.raw";
-    static const char* OUTPUT_SALT_AND_PEPPER_RAW_FILE_NAME  = "Lena_SaltAndPepper.raw";
-    static const char* OUTPUT_SEPARABLE_MEDIAN_RAW_FILE_NAME = "Lena_SeparableMedian.raw";
+    TraceScope trace("AdaptiveMedianBlur", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
+
+    static const int CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(&inputImage != &outputImage);
+    assert(maxWsize % 2 == 1);
 
-    FILE* fileStream;
+    const int    width     = static_cast<int>(inputImage.Width());
+    const int    height    = static_cast<int>(inputImage.Height());
+    const Sample maxSample = MaxSample<Pixel>();
 
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    // Under NONE no window outgrows the image, so neither does the window buffer
+    const int maxRadius = (border == BorderMode::NONE) ? (std::min({ maxWsize / 2, (width - 1) / 2, (height - 1) / 2 })) : (maxWsize / 2);
 
-    CreateSaltAndPepperNoise(inputImage, inputImage, 0.05F);
-    SeparableMedianBlur(inputImage, outputImage, 3);
+    outputImage.Resize(width, height);
 
-    fileStream = fopen(OUTPUT_SALT_AND_PEPPER_RAW_FILE_NAME, "w+b");
-    fwrite(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    // Sample (ix + dx, iy + dy) of one channel as the border mode sees it; NONE never asks for one outside the image
+    const auto windowSample = [&](int ix, int iy, int channel, int dx, int dy) {
+        ptrdiff_t column = ix + dx;
+        ptrdiff_t row    = iy + dy;
 
-    fileStream = fopen(OUTPUT_SEPARABLE_MEDIAN_RAW_FILE_NAME, "w+b");
-    fwrite(outputImage, sizeof(outputImage), 1, fileStream);
-    fclose(fileStream);
+        if (border != BorderMode::NONE)
+        {
+            column = BorderIndex(column, width, border);
+            row    = BorderIndex(row, height, border);
+
+            if (column < 0 || row < 0)
+                return borderValue;
+        }
+
+        return SampleRow(inputImage, row)[column * CHANNELS + channel];
+    };
+
+    // Clean samples are copied as they are, so the windows below only open on the impulses and the cost follows the noise ratio
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<Sample> window(static_cast<size_t>(2 * maxRadius + 1) * (2 * maxRadius + 1));
 
-    return 0;
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+        {
+            const Sample* inputRow  = SampleRow(inputImage, iy);
+            Sample*       outputRow = SampleRow(outputImage, iy);
+
+            memcpy(outputRow, inputRow, width * sizeof(Pixel));
+
+            for (int index = 0; index < width * CHANNELS; ++index)
+            {
+                if (inputRow[index] != 0 && inputRow[index] != maxSample)
+                    continue;
+
+                const int ix          = index / CHANNELS;
+                const int channel     = index % CHANNELS;
+                const int radiusLimit = (border == BorderMode::NONE) ? (std::min({ maxRadius, ix, iy, width - 1 - ix, height - 1 - iy })) : (maxRadius);
+                int       count       = 1;
+                Sample    median      = inputRow[index];
+
+                window[0] = inputRow[index];
+
+                // Each step adds only the ring around the previous window: selecting the median reorders the window but keeps its
+                // samples, so the ring can simply be appended
+                for (int radius = 1; radius <= radiusLimit; ++radius)
+                {
+                    for (int dx = -radius; dx <= radius; ++dx)
+                    {
+                        window[count++] = windowSample(ix, iy, channel, dx, -radius);
+                        window[count++] = windowSample(ix, iy, channel, dx, radius);
+                    }
+                    for (int dy = -radius + 1; dy < radius; ++dy)
+                    {
+                        window[count++] = windowSample(ix, iy, channel, -radius, dy);
+                        window[count++] = windowSample(ix, iy, channel, radius, dy);
+                    }
+
+                    std::nth_element(window.Data(), window.Data() + count / 2, window.Data() + count);
+                    median = window[count / 2];
+
+                    // A median strictly between the window's extremes is no impulse itself, otherwise the window grows
+                    const Sample minimum = *std::min_element(window.Data(), window.Data() + count / 2 + 1);
+                    const Sample maximum = *std::max_element(window.Data() + count / 2, window.Data() + count);
+
+                    if (minimum < median && median < maximum)
+                        break;
+                }
+
+                outputRow[index] = median;
+            }
+        }
+    });
+
+    return outputImage;
 }
 
+template Image&     AdaptiveMedianBlur(const Image&, Image&, const int, BorderMode, byte_t);
+template WideImage& AdaptiveMedianBlur(const WideImage&, WideImage&, const int, BorderMode, wbyte_t);
+template RGBImage&  AdaptiveMedianBlur(const RGBImage&, RGBImage&, const int, BorderMode, byte_t);
+template RGBAImage& AdaptiveMedianBlur(const RGBAImage&, RGBAImage&, const int, BorderMode, byte_t);
+
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
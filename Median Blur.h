@@ -0,0 +1,43 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef MEDIAN_BLUR_H
+#define MEDIAN_BLUR_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Border Mode.h"
+#include "Image.h"
+
+// +------------------------------------------< SALT AND PEPPER >-------------------------------------------+
+
+// Sets about ratio of the pixels to 0 or 255 at random. The same seed always gives the same noise, so runs are reproducible.
+Image& CreateSaltAndPepperNoise(const Image& inputImage, Image& outputImage, float ratio, uint64_t seed = 0);
+
+// +--------------------------------------------< MEDIAN BLUR >---------------------------------------------+
+
+// As with the averaging blurs, border other than NONE also filters the wsize / 2 frame the windows cannot cover inside the image
+template <typename Pixel>
+ImageBuffer<Pixel>& SeparableMedianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int wsize,
+                                        BorderMode border = BorderMode::NONE, PixelSample<Pixel> borderValue = 0);
+
+// +---------------------------------------< HISTOGRAM MEDIAN BLUR >----------------------------------------+
+
+// The running histograms hold 256 brightness bins, so these stay 8-bit grayscale
+
+Image& SeparableHistogramMedianBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border = BorderMode::NONE, byte_t borderValue = 0);
+
+Image& HistogramMedianBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border = BorderMode::NONE, byte_t borderValue = 0);
+
+// +----------------------------------------< ADAPTIVE MEDIAN BLUR >----------------------------------------+
+
+// Switching median for impulse noise. Only samples at 0 or the largest sample value count as impulses; each one grows its window
+// from 3 x 3 up to maxWsize x maxWsize until the window median lies strictly between the window minimum and maximum, and takes
+// that median, the last one if no window qualifies. All other samples are copied, so the cost follows the noise ratio rather than
+// the image size. Under NONE the windows stay inside the image, leaving impulses on the outermost rows and columns as they are.
+template <typename Pixel>
+ImageBuffer<Pixel>& AdaptiveMedianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int maxWsize = 7,
+                                       BorderMode border = BorderMode::NONE, PixelSample<Pixel> borderValue = 0);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
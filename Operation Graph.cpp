@@ -0,0 +1,415 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Convolution.h"
+#include "Histogram Equalization.h"
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Median Blur.h"
+#include "Operation Graph.h"
+#include "Parallel Executor.h"
+#include "Spatial Averaging.h"
+#include "Unsharp Masking.h"
+
+// +-----------------------------------------------< STAGE >------------------------------------------------+
+
+// A wrapping border makes the first rows read the last ones, so such a filter depends on the whole image and cannot be tiled
+static int WindowRadius(int radius, BorderMode border)
+{
+    return (border == BorderMode::WRAP) ? (-1) : (radius);
+}
+
+OperationGraph& OperationGraph::ApplyLUT(const byte_t* lut, const char* name)
+{
+    assert(lut != NULL);
+
+    stages.push_back({ name, 0, std::vector<byte_t>(lut, lut + 256), nullptr, nullptr, nullptr });
+
+    return *this;
+}
+
+OperationGraph& OperationGraph::ApplyHistogramLUT(const HistogramLUT& createLUT, const char* name)
+{
+    assert(createLUT != nullptr);
+
+    stages.push_back({ name, 0, {}, createLUT, nullptr, nullptr });
+
+    return *this;
+}
+
+OperationGraph& OperationGraph::Equalize()
+{
+    return ApplyHistogramLUT([](const Histogram& histogram, byte_t* lut) {
+        CreateEqualizationLUT(lut, histogram);
+    }, "HistogramEqualization");
+}
+
+OperationGraph& OperationGraph::Specify(BOI boi, const byte_t maxBrightness)
+{
+    return ApplyHistogramLUT([boi, maxBrightness](const Histogram& histogram, byte_t* lut) {
+        CreateSpecificationLUT(lut, histogram, boi, maxBrightness);
+    }, "HistogramSpecification");
+}
+
+OperationGraph& OperationGraph::Window(int radius, const WindowFilter& filter, const char* name)
+{
+    assert(radius >= -1);
+    assert(filter != nullptr);
+
+    stages.push_back({ name, radius, {}, nullptr, filter, nullptr });
+
+    return *this;
+}
+
+OperationGraph& OperationGraph::AveragingBlur(int wsize, BorderMode border)
+{
+    return Window(WindowRadius(wsize / 2, border), [wsize, border](const Image& inputImage, Image& outputImage) {
+        SlidingAveragingBlur(inputImage, outputImage, wsize, border);
+    }, "SlidingAveragingBlur");
+}
+
+OperationGraph& OperationGraph::GaussianBlur(float sigma, BorderMode border)
+{
+    return Window(WindowRadius(GaussianBlurRadius(sigma), border), [sigma, border](const Image& inputImage, Image& outputImage) {
+        ::GaussianBlur(inputImage, outputImage, sigma, border);
+    }, "GaussianBlur");
+}
+
+OperationGraph& OperationGraph::MedianBlur(int wsize, BorderMode border)
+{
+    return Window(WindowRadius(wsize / 2, border), [wsize, border](const Image& inputImage, Image& outputImage) {
+        HistogramMedianBlur(inputImage, outputImage, wsize, border);
+    }, "HistogramMedianBlur");
+}
+
+OperationGraph& OperationGraph::AdaptiveMedianBlur(int maxWsize, BorderMode border)
+{
+    return Window(WindowRadius(maxWsize / 2, border), [maxWsize, border](const Image& inputImage, Image& outputImage) {
+        ::AdaptiveMedianBlur(inputImage, outputImage, maxWsize, border);
+    }, "AdaptiveMedianBlur");
+}
+
+OperationGraph& OperationGraph::UnsharpMasking(float sigma, float lambda)
+{
+    return Window(GaussianBlurRadius(sigma), [sigma, lambda](const Image& inputImage, Image& outputImage) {
+        GaussianUnsharpMasking(inputImage, outputImage, sigma, lambda);
+    }, "GaussianUnsharpMasking");
+}
+
+OperationGraph& OperationGraph::Convolve(const ConvolutionKernel& kernel, BorderMode border)
+{
+    Window(WindowRadius(static_cast<int>(kernel.Height() / 2), border), [kernel, border](const Image& inputImage, Image& outputImage) {
+        ::Convolve(inputImage, outputImage, kernel, border);
+    }, "Convolve");
+
+    stages.back().resolve = [kernel, border](size_t width, size_t height, Stage& stage) {
+        const ConvolutionMethod method = SelectConvolutionMethod<byte_t>(kernel, width, height);
+
+        if (method == ConvolutionMethod::FFT)
+            stage.radius = -1;
+
+        stage.filter = [kernel, border, method](const Image& inputImage, Image& outputImage) {
+            ::Convolve(inputImage, outputImage, kernel, border, 0, method);
+        };
+    };
+
+    return *this;
+}
+
+// +-----------------------------------------------< FUSION >-----------------------------------------------+
+
+std::vector<OperationGraph::Pass> OperationGraph::CreatePasses(const std::vector<Stage>& stages)
+{
+    std::vector<Pass> passes(1, Pass{ {}, {}, false, false });
+
+    for (const Stage& stage : stages)
+    {
+        const bool whole = stage.filter != nullptr && stage.radius < 0;
+
+        // A whole-image filter runs in a pass of its own, and the windowed stages after it start a new tiled pass
+        if (stage.filter != nullptr && !passes.back().tiled.empty() && (whole || passes.back().whole))
+            passes.push_back(Pass{ {}, {}, false, false });
+
+        Pass& pass = passes.back();
+
+        // Pointwise stages after a windowed one map its tiles, unless they need the histogram of its whole result
+        if (stage.filter != nullptr)
+        {
+            pass.tiled.push_back(&stage);
+            pass.whole = whole;
+        }
+        else if (stage.createLUT == nullptr && !pass.tiled.empty())
+            pass.tiled.push_back(&stage);
+        else if (stage.createLUT != nullptr && !pass.tiled.empty())
+        {
+            pass.countHistogram = true;
+            passes.push_back(Pass{ { &stage }, {}, false, false });
+        }
+        else
+            pass.head.push_back(&stage);
+    }
+
+    return passes;
+}
+
+void OperationGraph::ComposeLUT(const std::vector<const Stage*>& stages, const Histogram& histogram, byte_t* lut)
+{
+    for (int brightness = 0; brightness < 256; ++brightness)
+        lut[brightness] = static_cast<byte_t>(brightness);
+
+    for (const Stage* stage : stages)
+    {
+        byte_t stageLUT[256];
+
+        if (stage->createLUT != nullptr)
+        {
+            Histogram mappedHistogram = {};
+
+            for (int brightness = 0; brightness < 256; ++brightness)
+                mappedHistogram[lut[brightness]] += histogram[brightness];
+            stage->createLUT(mappedHistogram, stageLUT);
+        }
+        else
+            memcpy(stageLUT, stage->lut.data(), 256);
+
+        for (int brightness = 0; brightness < 256; ++brightness)
+            lut[brightness] = stageLUT[lut[brightness]];
+    }
+}
+
+bool OperationGraph::IsEmpty() const
+{
+    return stages.empty();
+}
+
+std::string OperationGraph::Describe() const
+{
+    const std::vector<Pass> passes = CreatePasses(stages);
+    std::string             description;
+
+    for (const Pass& pass : passes)
+    {
+        const bool countsSource = &pass == &passes.front() && std::any_of(pass.head.begin(), pass.head.end(), [](const Stage* stage) {
+            return stage->createLUT != nullptr;
+        });
+
+        std::string line = (countsSource) ? ("histogram") : ("");
+        int         halo = 0;
+
+        auto append = [&](std::string& text, const char* separator, const std::string& item) {
+            text += (text.empty()) ? (item) : (separator + item);
+        };
+
+        std::string head;
+
+        for (const Stage* stage : pass.head)
+            append(head, " + ", stage->name);
+        if (!head.empty())
+            append(line, ", ", "LUT(" + head + ")");
+
+        std::string tiled;
+        std::string pointwise;
+
+        for (const Stage* stage : pass.tiled)
+        {
+            if (stage->filter == nullptr)
+            {
+                append(pointwise, " + ", stage->name);
+                continue;
+            }
+
+            if (!pointwise.empty())
+                append(tiled, " > ", "LUT(" + pointwise + ")");
+            pointwise.clear();
+
+            append(tiled, " > ", stage->name);
+            halo += stage->radius;
+        }
+        if (!pointwise.empty())
+            append(tiled, " > ", "LUT(" + pointwise + ")");
+
+        if (!tiled.empty())
+            append(line, " > ", ((pass.whole) ? ("image(" + tiled + ")") : ("tiles(" + tiled + ") halo " + std::to_string(halo))) + ((pass.countHistogram) ? (", histogram") : ("")));
+
+        description += line + "\n";
+    }
+
+    return description;
+}
+
+// +---------------------------------------------< EVALUATION >---------------------------------------------+
+
+// Tiles of about this many pixels keep a tile and its two scratch copies in the L2 cache of most processors
+static const size_t TILE_PIXELS = 1 << 18;
+
+Image& OperationGraph::Evaluate(const Image& inputImage, Image& outputImage) const
+{
+    TraceScope trace("OperationGraph", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
+
+    if (stages.empty() || inputImage.IsEmpty())
+        return CopyImage(inputImage, outputImage);
+
+    const size_t       width  = inputImage.Width();
+    const size_t       height = inputImage.Height();
+    std::vector<Stage> resolvedStages(stages);
+
+    for (Stage& stage : resolvedStages)
+        if (stage.resolve != nullptr)
+            stage.resolve(width, height, stage);
+
+    const std::vector<Pass> passes = CreatePasses(resolvedStages);
+
+    ScratchImage<byte_t> scratchImage;
+    Histogram            histogram    = {};
+    const Image*         currentImage = &inputImage;
+
+    // A tiled pass reads the halo rows of its neighbours, so it never writes the image it reads. The passes alternate between the
+    // output and a scratch image and start on whichever of the two makes the last one write the output.
+    size_t outOfPlacePasses = 0;
+
+    for (const Pass& pass : passes)
+        if (!pass.tiled.empty() || &pass == &passes.front())
+            ++outOfPlacePasses;
+
+    if (std::any_of(passes.front().head.begin(), passes.front().head.end(), [](const Stage* stage) { return stage->createLUT != nullptr; }))
+        AccumulateHistogram(inputImage, histogram);
+
+    for (const Pass& pass : passes)
+    {
+        byte_t     headLUT[256];
+        const bool mapped = !pass.head.empty();
+
+        if (mapped)
+            ComposeLUT(pass.head, histogram, headLUT);
+
+        if (pass.tiled.empty())
+        {
+            Image* targetImage = const_cast<Image*>(currentImage);
+
+            // Only the first pass reads the input image, any later one maps the image it was handed in place
+            if (currentImage == &inputImage)
+                targetImage = (outOfPlacePasses-- % 2 == 1) ? (&outputImage) : (static_cast<Image*>(&scratchImage));
+
+            if (targetImage == &scratchImage)
+                scratchImage.Resize(width, height);
+
+            currentImage = &ApplyBrightnessLUT(*currentImage, *targetImage, headLUT);
+            continue;
+        }
+
+        Image* targetImage = (outOfPlacePasses-- % 2 == 1) ? (&outputImage) : (static_cast<Image*>(&scratchImage));
+
+        if (targetImage == &scratchImage)
+            scratchImage.Resize(width, height);
+        else
+            outputImage.Resize(width, height);
+
+        // Adjacent pointwise stages of the tiles are composed once, up front
+        std::vector<const Stage*>        filters;
+        std::vector<std::vector<byte_t>> tileLUTs;
+        std::vector<const Stage*>        pointwise;
+        int                              halo = 0;
+
+        for (size_t index = 0; index <= pass.tiled.size(); ++index)
+        {
+            if (index < pass.tiled.size() && pass.tiled[index]->filter == nullptr)
+            {
+                pointwise.push_back(pass.tiled[index]);
+                continue;
+            }
+
+            if (!filters.empty())
+            {
+                tileLUTs.emplace_back((pointwise.empty()) ? (0) : (256));
+                if (!pointwise.empty())
+                    ComposeLUT(pointwise, histogram, tileLUTs.back().data());
+            }
+            pointwise.clear();
+
+            if (index < pass.tiled.size())
+            {
+                filters.push_back(pass.tiled[index]);
+                halo += std::max(pass.tiled[index]->radius, 0);
+            }
+        }
+
+        const Image& sourceImage = *currentImage;
+
+        // Filters rows rowBegin ... rowEnd - 1 plus the halo rows on either side, clipped to the image, so each of those rows sees
+        // exactly the rows it would see in the whole image; the halo rows come out wrong and are dropped
+        const auto filterTile = [&](size_t rowBegin, size_t rowEnd, ScratchImage<byte_t>* tileImages, Histogram& tileHistogram) {
+            const size_t viewBegin = (pass.whole || rowBegin <= static_cast<size_t>(halo)) ? (0) : (rowBegin - halo);
+            const size_t viewEnd   = (pass.whole) ? (height) : (std::min(height, rowEnd + halo));
+
+            // A borrowed view of the rows, only ever read
+            const Image  viewImage(const_cast<byte_t*>(sourceImage.Row(viewBegin)), width, viewEnd - viewBegin, sourceImage.Stride());
+            const Image* tileImage = &viewImage;
+            int          current   = 0;
+
+            tileImages[0].Resize(width, viewEnd - viewBegin);
+            tileImages[1].Resize(width, viewEnd - viewBegin);
+
+            if (mapped)
+                tileImage = &ApplyBrightnessLUT(viewImage, tileImages[current], headLUT);
+
+            for (size_t index = 0; index < filters.size(); ++index)
+            {
+                current = (tileImage == &tileImages[current]) ? (1 - current) : (current);
+                filters[index]->filter(*tileImage, tileImages[current]);
+                tileImage = &tileImages[current];
+
+                if (!tileLUTs[index].empty())
+                    ApplyBrightnessLUT(tileImages[current], tileImages[current], tileLUTs[index].data());
+            }
+
+            for (size_t iy = rowBegin; iy < rowEnd; ++iy)
+                memcpy(targetImage->Row(iy), tileImage->Row(iy - viewBegin), width);
+
+            if (pass.countHistogram)
+                AccumulateHistogram(Image(targetImage->Row(rowBegin), width, rowEnd - rowBegin, targetImage->Stride()), tileHistogram);
+        };
+
+        histogram = Histogram{};
+
+        // A whole-image pass is one tile, run from this thread so that its filters still spread their rows over the workers
+        if (pass.whole)
+        {
+            ScratchImage<byte_t> tileImages[2];
+
+            filterTile(0, height, tileImages, histogram);
+            currentImage = targetImage;
+            continue;
+        }
+
+        const size_t tileHeight = std::max<size_t>({ 4 * static_cast<size_t>(halo), TILE_PIXELS / width, 16 });
+
+        // Every band walks its rows tile by tile, the filters running serially inside each tile
+        histogram = ParallelReduceRows(0, height, Histogram{}, [&](size_t bandBegin, size_t bandEnd, Histogram& bandHistogram) {
+            ScratchImage<byte_t> tileImages[2];
+            const size_t         tileCount = (bandEnd - bandBegin + tileHeight - 1) / tileHeight;
+
+            for (size_t tile = 0; tile < tileCount; ++tile)
+                filterTile(bandBegin + tile * (bandEnd - bandBegin) / tileCount, bandBegin + (tile + 1) * (bandEnd - bandBegin) / tileCount, tileImages, bandHistogram);
+        }, [](Histogram& histogram, const Histogram& bandHistogram) {
+            for (int brightness = 0; brightness < 256; ++brightness)
+                histogram[brightness] += bandHistogram[brightness];
+        }, tileHeight);
+
+        currentImage = targetImage;
+    }
+
+    return CopyImage(*currentImage, outputImage);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,109 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef OPERATION_GRAPH_H
+#define OPERATION_GRAPH_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Border Mode.h"
+#include "Convolution.h"
+#include "Histogram Specification.h"
+#include "Histogram.h"
+#include "Image.h"
+
+// +------------------------------------------< OPERATION GRAPH >-------------------------------------------+
+
+// A chain of 8-bit operations that is only declared while it is built and runs as a whole in Evaluate, which fuses it:
+// - consecutive pointwise stages compose into one 256-entry table. Histogram-driven stages such as Equalize are pointwise too:
+//   their histogram is that of the last image actually written, pushed through the tables before them.
+// - windowed stages run tile by tile, each tile a band of rows plus the halo rows all of the fused windows reach, and the pointwise
+//   stages between and after them map every tile while it is still in cache. No intermediate image is ever written in full.
+// - a histogram-driven stage after a windowed one needs the histogram of the whole windowed result, so the tiled pass ends there.
+//   It counts that histogram from its tiles as it writes them, and the composed table opens the next pass.
+// The result equals running the operations one after the other.
+class OperationGraph
+{
+public:
+    // A table made from the histogram of the stage's input
+    typedef std::function<void(const Histogram& histogram, byte_t* lut)> HistogramLUT;
+
+    // A filter whose output rows depend on the input rows at most radius rows away. Tiles are cut from the image as borrowed views,
+    // so the filter must treat the first and last rows of its input like the border of an image, as all library filters do. A
+    // radius of -1 marks a filter that reads the whole image, e.g. through a WRAP border; it runs untiled in a pass of its own.
+    typedef std::function<void(const Image& inputImage, Image& outputImage)> WindowFilter;
+
+    // outputImage(x, y) = lut[inputImage(x, y)]; the 256 entries are copied
+    OperationGraph& ApplyLUT(const byte_t* lut, const char* name = "LUT");
+
+    OperationGraph& ApplyHistogramLUT(const HistogramLUT& createLUT, const char* name);
+
+    OperationGraph& Equalize();
+
+    OperationGraph& Specify(BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255);
+
+    OperationGraph& Window(int radius, const WindowFilter& filter, const char* name);
+
+    OperationGraph& AveragingBlur(int wsize, BorderMode border = BorderMode::REPLICATE);
+
+    OperationGraph& GaussianBlur(float sigma, BorderMode border = BorderMode::REPLICATE);
+
+    OperationGraph& MedianBlur(int wsize, BorderMode border = BorderMode::NONE);
+
+    OperationGraph& AdaptiveMedianBlur(int maxWsize = 7, BorderMode border = BorderMode::NONE);
+
+    // The blur, the difference and the clipping of GaussianUnsharpMasking in one tiled stage, so the blurred image stays per tile
+    OperationGraph& UnsharpMasking(float sigma, float lambda = 0.3F);
+
+    // The method is the one Convolve would pick for the whole image, resolved once Evaluate knows its size and then used for every
+    // tile. The result of the FFT depends on how the image is cut into transform tiles, so a stage that takes it runs untiled.
+    OperationGraph& Convolve(const ConvolutionKernel& kernel, BorderMode border = BorderMode::REPLICATE);
+
+    bool IsEmpty() const;
+
+    // The fused passes, one line each, e.g. "histogram, LUT(HistogramEqualization) > tiles(GaussianBlur > LUT) halo 6". Convolve
+    // stages are shown tiled; on an image large enough for the FFT they run untiled.
+    std::string Describe() const;
+
+    // Runs the chain on inputImage. outputImage must be a different buffer and may end up with a different stride.
+    Image& Evaluate(const Image& inputImage, Image& outputImage) const;
+
+private:
+    // Exactly one of lut, createLUT and filter is set. A filter whose behaviour depends on the size of the whole image also sets
+    // resolve, which Evaluate calls on a copy of the stage with that size before the passes are formed.
+    struct Stage
+    {
+        const char*                                                    name;
+        int                                                            radius;
+        std::vector<byte_t>                                            lut;
+        HistogramLUT                                                   createLUT;
+        WindowFilter                                                   filter;
+        std::function<void(size_t width, size_t height, Stage& stage)> resolve;
+    };
+
+    // Pointwise stages that are composed before the pass starts, then the windowed stages and the pointwise stages between and
+    // after them, applied tile by tile. A pass without windowed stages maps the whole image through one table, and a whole pass is
+    // a single tile spanning the image.
+    struct Pass
+    {
+        std::vector<const Stage*> head;
+        std::vector<const Stage*> tiled;
+        bool                      countHistogram;
+        bool                      whole;
+    };
+
+    static std::vector<Pass> CreatePasses(const std::vector<Stage>& stages);
+
+    // Composes stages into lut. A histogram-driven stage sees histogram, the one of the image the first stage reads, pushed through
+    // the stages before it, which is exactly the histogram of its own input.
+    static void ComposeLUT(const std::vector<const Stage*>& stages, const Histogram& histogram, byte_t* lut);
+
+    std::vector<Stage> stages;
+};
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
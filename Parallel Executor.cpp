@@ -0,0 +1,47 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Parallel Executor.h"
+
+// +--------------------------------------------< THREAD COUNT >--------------------------------------------+
+
+static std::mutex& GetThreadPoolMutex()
+{
+    static std::mutex threadPoolMutex;
+
+    return threadPoolMutex;
+}
+
+static std::unique_ptr<ThreadPool>& GetThreadPoolInstance()
+{
+    static std::unique_ptr<ThreadPool> threadPool(new ThreadPool(std::max(std::thread::hardware_concurrency(), 1U)));
+
+    return threadPool;
+}
+
+ThreadPool& GetThreadPool()
+{
+    std::lock_guard<std::mutex> lock(GetThreadPoolMutex());
+
+    return *GetThreadPoolInstance();
+}
+
+void SetThreadCount(size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::lock_guard<std::mutex> lock(GetThreadPoolMutex());
+
+    if (GetThreadPoolInstance()->GetThreadCount() != threadCount)
+    {
+        GetThreadPoolInstance().reset();
+        GetThreadPoolInstance().reset(new ThreadPool(threadCount));
+    }
+}
+
+size_t GetThreadCount()
+{
+    return GetThreadPool().GetThreadCount();
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
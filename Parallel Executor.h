@@ -0,0 +1,283 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef PARALLEL_EXECUTOR_H
+#define PARALLEL_EXECUTOR_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Instrumentation.h"
+
+// +--------------------------------------------< THREAD POOL >---------------------------------------------+
+
+// Persistent workers with one task queue each. A worker takes tasks from the front of its own queue and steals from the back of
+// the others once it runs dry, so bands stay in row order per worker while uneven bands still balance out.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount)
+        : queues(std::max<size_t>(threadCount, 1)), job(NULL), generation(0), pending(0), stop(false)
+    {
+        for (size_t worker = 1; worker < queues.size(); ++worker)
+            workers.emplace_back(&ThreadPool::WorkerLoop, this, worker);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wakeUp.notify_all();
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    size_t GetThreadCount() const
+    {
+        return queues.size();
+    }
+
+    // Runs task(0) ... task(taskCount - 1) and returns once all of them have finished. The calling thread works as worker 0.
+    // Calls made from inside a task run inline, and calls from several outside threads are serialized.
+    void Run(size_t taskCount, const std::function<void(size_t)>& task)
+    {
+        if (taskCount == 0)
+            return;
+
+        if (queues.size() == 1 || taskCount == 1 || IsInsideTask())
+        {
+            for (size_t index = 0; index < taskCount; ++index)
+                task(index);
+
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            job = &task;
+            pending.store(taskCount);
+
+            for (size_t worker = 0; worker < queues.size(); ++worker)
+            {
+                std::lock_guard<std::mutex> queueLock(queues[worker].mutex);
+
+                for (size_t index = worker * taskCount / queues.size(); index < (worker + 1) * taskCount / queues.size(); ++index)
+                    queues[worker].tasks.push_back(index);
+            }
+
+            ++generation;
+        }
+        wakeUp.notify_all();
+
+        ExecuteTasks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending.load() == 0; });
+        job = NULL;
+    }
+
+private:
+    friend class SerialScope;
+
+    struct TaskQueue
+    {
+        std::mutex         mutex;
+        std::deque<size_t> tasks;
+    };
+
+    static bool& IsInsideTask()
+    {
+        static thread_local bool insideTask = false;
+
+        return insideTask;
+    }
+
+    bool PopTask(size_t worker, size_t& index)
+    {
+        {
+            std::lock_guard<std::mutex> queueLock(queues[worker].mutex);
+
+            if (!queues[worker].tasks.empty())
+            {
+                index = queues[worker].tasks.front();
+                queues[worker].tasks.pop_front();
+
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < queues.size(); ++offset)
+        {
+            TaskQueue&                  victim = queues[(worker + offset) % queues.size()];
+            std::lock_guard<std::mutex> queueLock(victim.mutex);
+
+            if (!victim.tasks.empty())
+            {
+                index = victim.tasks.back();
+                victim.tasks.pop_back();
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ExecuteTasks(size_t worker)
+    {
+        size_t index;
+
+        while (PopTask(worker, index))
+        {
+            IsInsideTask() = true;
+            (*job)(index);
+            IsInsideTask() = false;
+
+            if (pending.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.notify_all();
+            }
+        }
+    }
+
+    void WorkerLoop(size_t worker)
+    {
+        size_t seenGeneration = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [&] { return stop || generation != seenGeneration; });
+
+                if (stop)
+                    return;
+
+                seenGeneration = generation;
+            }
+
+            ExecuteTasks(worker);
+        }
+    }
+
+    std::vector<TaskQueue>   queues;
+    std::vector<std::thread> workers;
+
+    std::mutex              runMutex;
+    std::mutex              mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+
+    const std::function<void(size_t)>* job;
+    size_t                             generation;
+    std::atomic<size_t>                pending;
+    bool                               stop;
+};
+
+// +--------------------------------------------< SERIAL SCOPE >--------------------------------------------+
+
+// Makes every Run call of the constructing thread execute inline, as if it came from inside a task, until the scope ends. For
+// callers that bring their own threads: a service running many small images side by side gains nothing from splitting each of them
+// into bands, and its threads would only queue up on the shared pool.
+class SerialScope
+{
+public:
+    SerialScope()
+        : insideTask(ThreadPool::IsInsideTask())
+    {
+        ThreadPool::IsInsideTask() = true;
+    }
+
+    SerialScope(const SerialScope&)            = delete;
+    SerialScope& operator=(const SerialScope&) = delete;
+
+    ~SerialScope()
+    {
+        ThreadPool::IsInsideTask() = insideTask;
+    }
+
+private:
+    const bool insideTask;
+};
+
+// +--------------------------------------------< THREAD COUNT >--------------------------------------------+
+
+// The shared pool lives in the library, so every caller of the library sees the same workers and the same thread count
+ThreadPool& GetThreadPool();
+
+// 0 selects one thread per hardware thread, 1 runs every operation serially on the calling thread.
+// Must not be called while an operation is running.
+void SetThreadCount(size_t threadCount);
+
+size_t GetThreadCount();
+
+// +--------------------------------------------< PARALLEL FOR >--------------------------------------------+
+
+// Splits [begin, end) into bands of whole rows and hands each band to band(bandBegin, bandEnd). Windowed filters read their halo
+// rows directly from the shared input, so a band only ever writes its own rows and the result does not depend on the split.
+inline void ParallelForRows(size_t begin, size_t end, const std::function<void(size_t, size_t)>& band, size_t minimumBandHeight = 16)
+{
+    if (begin >= end)
+        return;
+
+    ThreadPool&  threadPool = GetThreadPool();
+    const size_t rows       = end - begin;
+    const size_t bandHeight = std::max(minimumBandHeight, (rows + 8 * threadPool.GetThreadCount() - 1) / (8 * threadPool.GetThreadCount()));
+    const size_t bandCount  = (rows + bandHeight - 1) / bandHeight;
+
+    threadPool.Run(bandCount, [&](size_t index) {
+        TraceScope trace("ParallelForRows", "band");
+
+        band(begin + index * bandHeight, std::min(end, begin + (index + 1) * bandHeight));
+    });
+}
+
+// Row-band reduction: every band fills its own partial result starting from identity, and the partials are merged in band order
+// on the calling thread, which keeps integer reductions such as histograms bit-identical to a serial pass.
+template <typename Partial, typename Band, typename Merge>
+Partial ParallelReduceRows(size_t begin, size_t end, const Partial& identity, const Band& band, const Merge& merge, size_t minimumBandHeight = 16)
+{
+    Partial result = identity;
+
+    if (begin >= end)
+        return result;
+
+    ThreadPool&  threadPool = GetThreadPool();
+    const size_t rows       = end - begin;
+    const size_t bandHeight = std::max(minimumBandHeight, (rows + threadPool.GetThreadCount() - 1) / threadPool.GetThreadCount());
+    const size_t bandCount  = (rows + bandHeight - 1) / bandHeight;
+
+    std::vector<Partial> partials(bandCount, identity);
+
+    threadPool.Run(bandCount, [&](size_t index) {
+        TraceScope trace("ParallelReduceRows", "band");
+
+        band(begin + index * bandHeight, std::min(end, begin + (index + 1) * bandHeight), partials[index]);
+    });
+
+    for (const Partial& partial : partials)
+        merge(result, partial);
+
+    return result;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
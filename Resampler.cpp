@@ -0,0 +1,265 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Parallel Executor.h"
+#include "Resampler.h"
+
+// +-----------------------------------------< RESAMPLING FILTER >------------------------------------------+
+
+static const double PI = 3.14159265358979323846;
+
+// Half the width of the filter, in input pixels at a scale of 1
+static double FilterSupport(ResamplingFilter filter)
+{
+    switch (filter)
+    {
+    case ResamplingFilter::NEAREST:
+        return 0.5;
+    case ResamplingFilter::BILINEAR:
+        return 1.0;
+    case ResamplingFilter::BICUBIC:
+        return 2.0;
+    default:
+        return 3.0;
+    }
+}
+
+static double Sinc(double x)
+{
+    return (x == 0.0) ? (1.0) : (sin(PI * x) / (PI * x));
+}
+
+static double FilterWeight(ResamplingFilter filter, double x)
+{
+    x = fabs(x);
+
+    switch (filter)
+    {
+    case ResamplingFilter::NEAREST:
+        return (x < 0.5) ? (1.0) : (0.0);
+    case ResamplingFilter::BILINEAR:
+        return (x < 1.0) ? (1.0 - x) : (0.0);
+    case ResamplingFilter::BICUBIC:
+        // Keys' cubic convolution with a = -0.5, the one that reproduces quadratics
+        if (x < 1.0)
+            return (1.5 * x - 2.5) * x * x + 1.0;
+        if (x < 2.0)
+            return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+        return 0.0;
+    default:
+        return (x < 3.0) ? (Sinc(x) * Sinc(x / 3.0)) : (0.0);
+    }
+}
+
+// +------------------------------------------< RESAMPLING TAPS >-------------------------------------------+
+
+// The input pixels and weights each output position along one axis blends. Every position has the same number of taps, padded
+// with zero weights, so the inner loops have a fixed trip count.
+struct ResamplingTaps
+{
+    size_t             taps;
+    size_t             span;
+    std::vector<int>   indices;
+    std::vector<float> weights;
+};
+
+static void CreateResamplingTaps(ResamplingFilter filter, size_t inputLength, size_t outputLength, ResamplingTaps& resamplingTaps)
+{
+    const double scale       = static_cast<double>(inputLength) / static_cast<double>(outputLength);
+    const double filterScale = (filter == ResamplingFilter::NEAREST) ? (1.0) : (std::max(scale, 1.0));
+    const double support     = FilterSupport(filter) * filterScale;
+
+    std::vector<std::vector<std::pair<int, double>>> positions(outputLength);
+
+    resamplingTaps.taps = 1;
+    resamplingTaps.span = 1;
+
+    for (size_t position = 0; position < outputLength; ++position)
+    {
+        const double centre = (position + 0.5) * scale;
+
+        std::vector<std::pair<int, double>>& taps = positions[position];
+
+        if (filter == ResamplingFilter::NEAREST)
+            taps.push_back({ static_cast<int>(std::min<double>(floor(centre), inputLength - 1)), 1.0 });
+        else
+        {
+            double weightSum = 0.0;
+
+            // Taps outside the image fold onto the border pixel, which replicates it without any bounds checks later on
+            for (long index = static_cast<long>(floor(centre - support)); index <= static_cast<long>(ceil(centre + support)); ++index)
+            {
+                const double weight = FilterWeight(filter, (index + 0.5 - centre) / filterScale);
+
+                if (weight == 0.0)
+                    continue;
+
+                const int clampedIndex = static_cast<int>(std::min<long>(std::max<long>(index, 0), inputLength - 1));
+
+                if (!taps.empty() && taps.back().first == clampedIndex)
+                    taps.back().second += weight;
+                else
+                    taps.push_back({ clampedIndex, weight });
+                weightSum += weight;
+            }
+
+            for (std::pair<int, double>& tap : taps)
+                tap.second /= weightSum;
+        }
+
+        resamplingTaps.taps = std::max(resamplingTaps.taps, taps.size());
+        resamplingTaps.span = std::max<size_t>(resamplingTaps.span, taps.back().first - taps.front().first + 1);
+    }
+
+    resamplingTaps.indices.assign(outputLength * resamplingTaps.taps, 0);
+    resamplingTaps.weights.assign(outputLength * resamplingTaps.taps, 0.0F);
+
+    for (size_t position = 0; position < outputLength; ++position)
+        for (size_t tap = 0; tap < positions[position].size(); ++tap)
+        {
+            resamplingTaps.indices[position * resamplingTaps.taps + tap] = positions[position][tap].first;
+            resamplingTaps.weights[position * resamplingTaps.taps + tap] = static_cast<float>(positions[position][tap].second);
+        }
+
+    // Padding taps repeat the first index, so they read a pixel that is loaded anyway
+    for (size_t position = 0; position < outputLength; ++position)
+        for (size_t tap = positions[position].size(); tap < resamplingTaps.taps; ++tap)
+            resamplingTaps.indices[position * resamplingTaps.taps + tap] = positions[position][0].first;
+}
+
+// +---------------------------------------------< RESAMPLER >----------------------------------------------+
+
+// Filters one input row of samples, Channels per pixel, into outputWidth pixels of single-precision samples
+template <size_t Channels, typename Sample>
+static void ResampleRow(const Sample* inputRow, float* outputRow, size_t outputWidth, const ResamplingTaps& columnTaps)
+{
+    const int*   indices = columnTaps.indices.data();
+    const float* weights = columnTaps.weights.data();
+
+    for (size_t ix = 0; ix < outputWidth; ++ix, indices += columnTaps.taps, weights += columnTaps.taps)
+    {
+        float sums[Channels] = {};
+
+        for (size_t tap = 0; tap < columnTaps.taps; ++tap)
+            for (size_t channel = 0; channel < Channels; ++channel)
+                sums[channel] += weights[tap] * inputRow[indices[tap] * Channels + channel];
+
+        for (size_t channel = 0; channel < Channels; ++channel)
+            outputRow[ix * Channels + channel] = sums[channel];
+    }
+}
+
+template <typename Pixel>
+ImageBuffer<Pixel>& Resample(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, size_t outputWidth, size_t outputHeight, ResamplingFilter filter)
+{
+    TraceScope trace("Resample", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
+
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(&inputImage != &outputImage);
+
+    outputImage.Resize(outputWidth, outputHeight);
+
+    if (inputImage.IsEmpty() || outputImage.IsEmpty())
+        return outputImage;
+
+    ResamplingTaps columnTaps;
+    ResamplingTaps rowTaps;
+
+    CreateResamplingTaps(filter, inputImage.Width(), outputWidth, columnTaps);
+    CreateResamplingTaps(filter, inputImage.Height(), outputHeight, rowTaps);
+
+    // Nearest neighbour has one tap of weight 1, so it gathers pixels directly and copies a row that repeats the one before
+    if (filter == ResamplingFilter::NEAREST)
+    {
+        ParallelForRows(0, outputHeight, [&](size_t bandBegin, size_t bandEnd) {
+            for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+            {
+                Pixel* outputRow = outputImage.Row(iy);
+
+                if (iy != bandBegin && rowTaps.indices[iy] == rowTaps.indices[iy - 1])
+                {
+                    memcpy(outputRow, outputImage.Row(iy - 1), outputWidth * sizeof(Pixel));
+                    continue;
+                }
+
+                const Pixel* inputRow = inputImage.Row(rowTaps.indices[iy]);
+
+                for (size_t ix = 0; ix < outputWidth; ++ix)
+                    outputRow[ix] = inputRow[columnTaps.indices[ix]];
+            }
+        });
+
+        return outputImage;
+    }
+
+    // The rows one output row blends lie within rowTaps.span consecutive input rows, so a ring of that many filtered rows, slot
+    // iy % span holding input row iy, always has all of them at once and never filters an input row twice within a band
+    const size_t ringSize     = rowTaps.span;
+    const size_t outputSamples = outputWidth * CHANNELS;
+    const float  maxSample     = MaxSample<Pixel>();
+
+    ParallelForRows(0, outputHeight, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<float> ring(ringSize * outputSamples);
+        ScratchBuffer<float> sums(outputSamples);
+        std::vector<int>     ringRows(ringSize, -1);
+
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const int*   indices = &rowTaps.indices[iy * rowTaps.taps];
+            const float* weights = &rowTaps.weights[iy * rowTaps.taps];
+
+            std::fill_n(sums.Data(), outputSamples, 0.0F);
+
+            for (size_t tap = 0; tap < rowTaps.taps; ++tap)
+            {
+                if (weights[tap] == 0.0F)
+                    continue;
+
+                const size_t slot = indices[tap] % ringSize;
+
+                if (ringRows[slot] != indices[tap])
+                {
+                    ResampleRow<CHANNELS>(SampleRow(inputImage, indices[tap]), &ring[slot * outputSamples], outputWidth, columnTaps);
+                    ringRows[slot] = indices[tap];
+                }
+
+                const float* ringRow = &ring[slot * outputSamples];
+                const float  weight  = weights[tap];
+
+                for (size_t index = 0; index < outputSamples; ++index)
+                    sums[index] += weight * ringRow[index];
+            }
+
+            Sample* outputRow = SampleRow(outputImage, iy);
+
+            // Bicubic and Lanczos lobes overshoot at edges, so the sums are clamped before they are rounded
+            for (size_t index = 0; index < outputSamples; ++index)
+                outputRow[index] = static_cast<Sample>(std::min(std::max(sums[index], 0.0F), maxSample) + 0.5F);
+        }
+    });
+
+    return outputImage;
+}
+
+template Image&     Resample(const Image&, Image&, size_t, size_t, ResamplingFilter);
+template WideImage& Resample(const WideImage&, WideImage&, size_t, size_t, ResamplingFilter);
+template RGBImage&  Resample(const RGBImage&, RGBImage&, size_t, size_t, ResamplingFilter);
+template RGBAImage& Resample(const RGBAImage&, RGBAImage&, size_t, size_t, ResamplingFilter);
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,36 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cinttypes>
+#include <cstddef>
+
+#include "Image.h"
+
+// +-----------------------------------------< RESAMPLING FILTER >------------------------------------------+
+
+enum class ResamplingFilter : uint8_t
+{
+    NEAREST  = 0,
+    BILINEAR = 1,
+    BICUBIC  = 2,
+    LANCZOS  = 3
+};
+
+// +---------------------------------------------< RESAMPLER >----------------------------------------------+
+
+// Scales inputImage to outputWidth x outputHeight by any factor, up or down and independently per axis. Pixel centres are aligned,
+// the border is replicated and downscaling widens the filter by the factor, so shrinking averages instead of aliasing. The filter
+// taps of every column and row are tabulated once; output rows are then produced in order from a small ring of horizontally
+// filtered input rows, so each input row is read and filtered once per band and the whole resize is a single streamed pass.
+// NEAREST with an integer factor reproduces ZeroOrderInterpolator.
+template <typename Pixel>
+ImageBuffer<Pixel>& Resample(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, size_t outputWidth, size_t outputHeight,
+                             ResamplingFilter filter = ResamplingFilter::BILINEAR);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -6,212 +6,542 @@
 
 // +----------------------------------------------< INCLUDE >-----------------------------------------------+
 
-#include <Windows.h>
-
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
-#include <cstdio>
+#include <cmath>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
-// +---------------------------------------------< CHECK TIME >---------------------------------------------+
-
-#define CHECK_TIME_START(start, freq)            { if (QueryPerformanceFrequency((LARGE_INTEGER*)&freq)) QueryPerformanceCounter((LARGE_INTEGER*)&start); }
-#define CHECK_TIME_END(start, freq, elapsedTime) { __int64 end; QueryPerformanceCounter((LARGE_INTEGER*)&end); elapsedTime = ((float)end - (float)start) / (float)freq * 1000.0F; }
-
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
-
-typedef uint8_t  byte_t;
-typedef uint32_t lbyte_t;
-
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
-
-static const size_t WIDTH  = 3136;
-static const size_t HEIGHT = 2199;
-
-byte_t  inputImage[WIDTH * HEIGHT];
-byte_t  spatialAveragingImage[WIDTH * HEIGHT];
-byte_t  separableSpatialAveragingImage[WIDTH * HEIGHT];
-lbyte_t integralImage[WIDTH * HEIGHT];
-byte_t  normalizationIntegralImage[WIDTH * HEIGHT];
-byte_t  integralSpatialAveragingImage[WIDTH * HEIGHT];
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Integral Kernel.h"
+#include "Parallel Executor.h"
+#include "Spatial Averaging.h"
 
 // +-------------------------------------------< AVERAGING BLUR >-------------------------------------------+
 
-byte_t CalculatePixelWindowAverage(byte_t* image, POINT center, SIZE wsize)
+static byte_t CalculatePixelWindowAverage(const Image& image, PixelPoint center, WindowSize wsize)
 {
-    assert(image != NULL);
-    assert(center.x >= wsize.cx / 2 && center.x < WIDTH - wsize.cx / 2);
-    assert(center.y >= wsize.cy / 2 && center.y < HEIGHT - wsize.cy / 2);
+    assert(center.x >= wsize.cx / 2 && center.x < static_cast<int>(image.Width()) - wsize.cx / 2);
+    assert(center.y >= wsize.cy / 2 && center.y < static_cast<int>(image.Height()) - wsize.cy / 2);
     assert(wsize.cx % 2 == 1);
     assert(wsize.cy % 2 == 1);
 
     long pixelSum = 0;
 
     for (int wy = -wsize.cy / 2; wy <= wsize.cy / 2; ++wy)
+    {
+        const byte_t* imageRow = image.Row(center.y + wy);
+
         for (int wx = -wsize.cx / 2; wx <= wsize.cx / 2; ++wx)
-            pixelSum += inputImage[(center.y + wy) * WIDTH + (center.x + wx)];
+            pixelSum += imageRow[center.x + wx];
+    }
 
     return static_cast<byte_t>(pixelSum / (wsize.cx * wsize.cy) + 0.5);
 }
 
-byte_t CalculateIntegralWindowAverage(lbyte_t* integralImage, POINT center, SIZE wsize)
+static byte_t CalculateIntegralWindowAverage(const IntegralImage& integralImage, PixelPoint center, WindowSize wsize)
 {
-    assert(integralImage != NULL);
-    assert(center.x >= wsize.cx / 2 && center.x < WIDTH - wsize.cx / 2);
-    assert(center.y >= wsize.cy / 2 && center.y < HEIGHT - wsize.cy / 2);
+    assert(center.x >= wsize.cx / 2 && center.x < static_cast<int>(integralImage.Width()) - wsize.cx / 2);
+    assert(center.y >= wsize.cy / 2 && center.y < static_cast<int>(integralImage.Height()) - wsize.cy / 2);
     assert(wsize.cx % 2 == 1);
     assert(wsize.cy % 2 == 1);
 
-    long integralSum = integralImage[(center.y + wsize.cy / 2) * WIDTH + (center.x + wsize.cx / 2)];
+    long integralSum = integralImage(center.x + wsize.cx / 2, center.y + wsize.cy / 2);
 
     if (center.x > wsize.cx / 2)
-        integralSum -= integralImage[(center.y + wsize.cy / 2) * WIDTH + (center.x - wsize.cx / 2 - 1)];
+        integralSum -= integralImage(center.x - wsize.cx / 2 - 1, center.y + wsize.cy / 2);
     if (center.y > wsize.cy / 2)
-        integralSum -= integralImage[(center.y - wsize.cy / 2 - 1) * WIDTH + (center.x + wsize.cx / 2)];
+        integralSum -= integralImage(center.x + wsize.cx / 2, center.y - wsize.cy / 2 - 1);
     if (center.x > wsize.cx / 2 && center.y > wsize.cy / 2)
-        integralSum += integralImage[(center.y - wsize.cy / 2 - 1) * WIDTH + (center.x - wsize.cx / 2 - 1)];
+        integralSum += integralImage(center.x - wsize.cx / 2 - 1, center.y - wsize.cy / 2 - 1);
 
     return static_cast<byte_t>(integralSum / (wsize.cx * wsize.cy) + 0.5);
 }
 
-lbyte_t* CreateIntegralImage(byte_t* inputImage, lbyte_t* integralImage)
+IntegralImage& CreateIntegralImage(const Image& inputImage, IntegralImage& integralImage)
 {
-    assert(inputImage    != NULL);
-    assert(integralImage != NULL);
+    TraceScope trace("CreateIntegralImage", inputImage, integralImage);
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        integralImage[iy * WIDTH] = inputImage[iy * WIDTH];
+    integralImage.Resize(inputImage.Width(), inputImage.Height());
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        for (int ix = 1; ix < WIDTH; ++ix)
-            integralImage[iy * WIDTH + ix] = inputImage[iy * WIDTH + ix] + integralImage[iy * WIDTH + (ix - 1)];
-
-    for (int ix = 0; ix < WIDTH; ++ix)
-        for (int iy = 1; iy < HEIGHT; ++iy)
-            integralImage[iy * WIDTH + ix] += integralImage[(iy - 1) * WIDTH + ix];
+    // Single row-major pass: each row is its own prefix sum plus the finished row above, so no pass strides down the columns
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        IntegralImageRow(inputImage.Row(iy), (iy > 0) ? (integralImage.Row(iy - 1)) : (NULL), integralImage.Row(iy), inputImage.Width());
 
     return integralImage;
 }
 
-byte_t* NormalizationIntegralImage(lbyte_t* integralImage, byte_t* normalizationIntegralImage)
+Image& NormalizationIntegralImage(const IntegralImage& integralImage, Image& normalizationIntegralImage)
 {
-    assert(integralImage              != NULL);
-    assert(normalizationIntegralImage != NULL);
+    TraceScope trace("NormalizationIntegralImage", integralImage, normalizationIntegralImage);
+
+    const size_t width  = integralImage.Width();
+    const size_t height = integralImage.Height();
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        for (int ix = 0; ix < WIDTH; ++ix)
-            normalizationIntegralImage[iy * WIDTH + ix] = static_cast<float>(integralImage[iy * WIDTH + ix]) / static_cast<float>(integralImage[WIDTH * HEIGHT - 1]) * 255;
+    normalizationIntegralImage.Resize(width, height);
+
+    for (size_t iy = 0; iy < height; ++iy)
+        for (size_t ix = 0; ix < width; ++ix)
+            normalizationIntegralImage(ix, iy) = static_cast<float>(integralImage(ix, iy)) / static_cast<float>(integralImage(width - 1, height - 1)) * 255;
 
     return normalizationIntegralImage;
 }
 
-byte_t* AveragingBlur(byte_t* inputImage, byte_t* outputImage, const int wsize)
+Image& AveragingBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border, byte_t borderValue)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("AveragingBlur", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
     assert(wsize % 2   == 1);
 
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
 
-    for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
-            outputImage[iy * WIDTH + ix] = CalculatePixelWindowAverage(inputImage, { ix, iy }, { wsize, wsize });
+    const auto filterBorder = [&](const Image& borderImage, Image& filteredImage) {
+        AveragingBlur(borderImage, filteredImage, wsize);
+    };
 
-    return outputImage;
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
+
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+            for (int ix = wsize / 2; ix < width - wsize / 2; ++ix)
+                outputImage(ix, iy) = CalculatePixelWindowAverage(inputImage, { ix, iy }, { wsize, wsize });
+    });
+
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
 }
 
-byte_t* SeparableAveragingBlur(byte_t* inputImage, byte_t* outputImage, const int wsize)
+Image& SeparableAveragingBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border, byte_t borderValue)
 {
-    assert(inputImage  != NULL);
-    assert(outputImage != NULL);
+    TraceScope trace("SeparableAveragingBlur", inputImage, outputImage);
+
+    assert(&inputImage != &outputImage);
     assert(wsize % 2   == 1);
 
-    byte_t* interimImage = new byte_t[WIDTH * HEIGHT];
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
 
-    memcpy(interimImage, inputImage, WIDTH * HEIGHT);
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+    const auto filterBorder = [&](const Image& borderImage, Image& filteredImage) {
+        SeparableAveragingBlur(borderImage, filteredImage, wsize);
+    };
 
-    for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
-            interimImage[iy * WIDTH + ix] = CalculatePixelWindowAverage(inputImage, { ix, iy }, { 1, wsize });
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
 
-    for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
-            outputImage[iy * WIDTH + ix] = CalculatePixelWindowAverage(interimImage, { ix, iy }, { wsize, 1 });
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
 
-    delete[] interimImage;
+    // Both passes read the input or the interim image and neither writes its source, so the interim image only needs the rows the
+    // horizontal pass reads, all of which the vertical pass writes
+    ScratchImage<byte_t> interimImage(width, height);
 
-    return outputImage;
+    // The vertical pass covers every column so that the horizontal pass never averages unfiltered border columns into the interior
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+            for (int ix = 0; ix < width; ++ix)
+                interimImage(ix, iy) = CalculatePixelWindowAverage(inputImage, { ix, iy }, { 1, wsize });
+    });
+
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+            for (int ix = wsize / 2; ix < width - wsize / 2; ++ix)
+                outputImage(ix, iy) = CalculatePixelWindowAverage(interimImage, { ix, iy }, { wsize, 1 });
+    });
+
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
 }
 
-byte_t* IntegralAveragingBlur(byte_t* inputImage, lbyte_t* integralImage, byte_t* outputImage, const int wsize)
+Image& IntegralAveragingBlur(const Image& inputImage, const IntegralImage& integralImage, Image& outputImage, const int wsize, BorderMode border, byte_t borderValue)
 {
-    assert(inputImage    != NULL);
-    assert(integralImage != NULL);
-    assert(outputImage   != NULL);
+    TraceScope trace("IntegralAveragingBlur", inputImage, outputImage);
+
+    assert(&inputImage            != &outputImage);
+    assert(integralImage.Width()  == inputImage.Width());
+    assert(integralImage.Height() == inputImage.Height());
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+
+    const auto filterBorder = [&](const Image& borderImage, Image& filteredImage) {
+        ScratchImage<lbyte_t> borderIntegralImage(borderImage.Width(), borderImage.Height());
+        IntegralAveragingBlur(borderImage, CreateIntegralImage(borderImage, borderIntegralImage), filteredImage, wsize);
+    };
+
+    if (border == BorderMode::NONE)
+        CopyImage(inputImage, outputImage);
+    else
+        outputImage.Resize(width, height);
+
+    if (wsize > width || wsize > height)
+        return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+
+    // Only the first window row and column touch the image border, every other window takes the branch-free row kernel
+    ParallelForRows(wsize / 2, height - wsize / 2, [&](size_t bandBegin, size_t bandEnd) {
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+        {
+            if (iy == wsize / 2)
+            {
+                for (int ix = wsize / 2; ix < width - wsize / 2; ++ix)
+                    outputImage(ix, iy) = CalculateIntegralWindowAverage(integralImage, { ix, iy }, { wsize, wsize });
+
+                continue;
+            }
+
+            outputImage(wsize / 2, iy) = CalculateIntegralWindowAverage(integralImage, { wsize / 2, iy }, { wsize, wsize });
+            IntegralBoxAverageRow(integralImage.Row(iy - wsize / 2 - 1), integralImage.Row(iy + wsize / 2), outputImage.Row(iy) + (wsize / 2 + 1),
+                                  width - wsize, wsize, wsize * wsize);
+        }
+    });
+
+    return FilterBorder(inputImage, outputImage, wsize / 2, border, borderValue, filterBorder);
+}
+
+// +---------------------------------------< SLIDING AVERAGING BLUR >---------------------------------------+
+
+// Adds input row iy, seen through the border, to the running column sums of its samples, or takes it out again
+template <typename Pixel>
+static void AccumulateColumnSums(const ImageBuffer<Pixel>& inputImage, ptrdiff_t iy, BorderMode border, PixelSample<Pixel> borderValue, lbyte_t* columnSums, bool subtract)
+{
+    const size_t    samples   = inputImage.Width() * PixelTraits<Pixel>::CHANNELS;
+    const ptrdiff_t sourceRow = BorderIndex(iy, inputImage.Height(), border);
+
+    if (sourceRow < 0)
+    {
+        for (size_t index = 0; index < samples; ++index)
+            columnSums[index] += (subtract) ? (0U - borderValue) : (borderValue);
+
+        return;
+    }
+
+    const PixelSample<Pixel>* inputRow = SampleRow(inputImage, sourceRow);
+
+    // Separate loops keep both directions branch-free, so the compiler vectorizes them; unsigned wrap-around makes the
+    // subtraction exact even while a sum is briefly smaller than the row taken out
+    if (subtract)
+        for (size_t index = 0; index < samples; ++index)
+            columnSums[index] -= inputRow[index];
+    else
+        for (size_t index = 0; index < samples; ++index)
+            columnSums[index] += inputRow[index];
+}
 
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+template <typename Pixel>
+ImageBuffer<Pixel>& SlidingAveragingBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int wsize, BorderMode border,
+                                         PixelSample<Pixel> borderValue)
+{
+    TraceScope trace("SlidingAveragingBlur", inputImage, outputImage);
+
+    typedef PixelSample<Pixel> Sample;
+
+    // An 8-bit window sum of at most 255 * 4103^2 still fits 32 bits, wider samples take 64; a column sum fits 32 bits either way
+    typedef typename std::conditional<sizeof(Sample) == 1, lbyte_t, uint64_t>::type WindowSum;
 
-    for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
-            outputImage[iy * WIDTH + ix] = CalculateIntegralWindowAverage(integralImage, { ix, iy }, { wsize, wsize });
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(&inputImage != &outputImage);
+    assert(wsize % 2   == 1);
+    assert(wsize       <= 4103);
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+    const int radius = wsize / 2;
+
+    outputImage.Resize(width, height);
+
+    if (inputImage.IsEmpty())
+        return outputImage;
+
+    size_t rowBegin = 0;
+    size_t rowEnd   = height;
+
+    // NONE filters only the windows that fit inside the image and keeps the input elsewhere, exactly like IntegralAveragingBlur
+    if (border == BorderMode::NONE)
+    {
+        CopyImage(inputImage, outputImage);
+
+        if (wsize > width || wsize > height)
+            return outputImage;
+
+        rowBegin = radius;
+        rowEnd   = height - radius;
+    }
+
+    // Under NONE no window that is kept reaches outside, so any border mode serves to fill the unused padding
+    const BorderMode sourceBorder = (border == BorderMode::NONE) ? (BorderMode::REPLICATE) : (border);
+    const double     inverseArea  = 1.0 / (static_cast<double>(wsize) * wsize);
+
+    // Source column of each of the radius padding columns on either side, -1 for the constant border
+    std::vector<ptrdiff_t> paddingColumns(2 * radius);
+
+    for (int index = 0; index < radius; ++index)
+    {
+        paddingColumns[index]          = BorderIndex(index - radius, width, sourceBorder);
+        paddingColumns[radius + index] = BorderIndex(width + index, width, sourceBorder);
+    }
+
+    // One row of 32-bit column sums runs down each band, taking one input row in and one out per output row; along the row a
+    // running window sum per channel does the same with the padded column sums. Both are O(1) per pixel whatever the window
+    // size. Each band opens with wsize rows to build its first column sums.
+    ParallelForRows(rowBegin, rowEnd, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<lbyte_t> columnSums(width * CHANNELS);
+        ScratchBuffer<lbyte_t> paddedSums((width + 2 * radius) * CHANNELS);
+
+        std::fill_n(columnSums.Data(), width * CHANNELS, 0);
+
+        for (ptrdiff_t iy = static_cast<ptrdiff_t>(bandBegin) - radius; iy <= static_cast<ptrdiff_t>(bandBegin) + radius; ++iy)
+            AccumulateColumnSums(inputImage, iy, sourceBorder, borderValue, columnSums.Data(), false);
+
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            memcpy(&paddedSums[radius * CHANNELS], columnSums.Data(), width * CHANNELS * sizeof(lbyte_t));
+
+            for (int index = 0; index < radius; ++index)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                {
+                    const ptrdiff_t leftColumn  = paddingColumns[index];
+                    const ptrdiff_t rightColumn = paddingColumns[radius + index];
+
+                    paddedSums[index * CHANNELS + channel]                    = (leftColumn < 0) ? (borderValue * wsize) : (columnSums[leftColumn * CHANNELS + channel]);
+                    paddedSums[(width + radius + index) * CHANNELS + channel] = (rightColumn < 0) ? (borderValue * wsize) : (columnSums[rightColumn * CHANNELS + channel]);
+                }
+
+            Sample*   outputRow = SampleRow(outputImage, iy);
+            WindowSum windowSums[CHANNELS] = {};
+
+            for (int index = 0; index < wsize - 1; ++index)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                    windowSums[channel] += paddedSums[index * CHANNELS + channel];
+
+            // The quotient goes through double precision like the integral kernels: (sum + 0.5) / area is at least 0.5 / area away
+            // from the next integer, so truncating reproduces the integer division exactly
+            for (int ix = 0; ix < width; ++ix)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                {
+                    windowSums[channel]              += paddedSums[(ix + wsize - 1) * CHANNELS + channel];
+                    outputRow[ix * CHANNELS + channel]  = static_cast<Sample>((windowSums[channel] + 0.5) * inverseArea);
+                    windowSums[channel]              -= paddedSums[ix * CHANNELS + channel];
+                }
+
+            if (border == BorderMode::NONE)
+            {
+                memcpy(outputImage.Row(iy), inputImage.Row(iy), radius * sizeof(Pixel));
+                memcpy(outputImage.Row(iy) + width - radius, inputImage.Row(iy) + width - radius, radius * sizeof(Pixel));
+            }
+
+            if (iy + 1 < bandEnd)
+            {
+                AccumulateColumnSums(inputImage, static_cast<ptrdiff_t>(iy) + radius + 1, sourceBorder, borderValue, columnSums.Data(), false);
+                AccumulateColumnSums(inputImage, static_cast<ptrdiff_t>(iy) - radius, sourceBorder, borderValue, columnSums.Data(), true);
+            }
+        }
+    }, 4 * wsize);
 
     return outputImage;
 }
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
+template Image&     SlidingAveragingBlur(const Image&, Image&, const int, BorderMode, byte_t);
+template WideImage& SlidingAveragingBlur(const WideImage&, WideImage&, const int, BorderMode, wbyte_t);
+template RGBImage&  SlidingAveragingBlur(const RGBImage&, RGBImage&, const int, BorderMode, byte_t);
+template RGBAImage& SlidingAveragingBlur(const RGBAImage&, RGBAImage&, const int, BorderMode, byte_t);
+
+// +-------------------------------------------< GAUSSIAN BLUR >--------------------------------------------+
+
+// Rows of samples in single precision, CHANNELS per pixel
+typedef ImageBuffer<float> BlurImage;
+
+static const int GAUSSIAN_PASSES = 3;
+
+// Odd box widths whose cascade has the variance sigma^2 of the Gaussian, each box adding (w^2 - 1) / 12: the ideal common width
+// rounded down to an odd narrow width, and as many passes widened by two as bring the total closest to sigma^2
+static void CreateGaussianBoxWidths(float sigma, int boxWidths[GAUSSIAN_PASSES])
+{
+    const double variance    = 12.0 * sigma * sigma;
+    int          narrowWidth = static_cast<int>(std::sqrt(variance / GAUSSIAN_PASSES + 1.0));
+
+    if (narrowWidth % 2 == 0)
+        --narrowWidth;
+
+    const double narrowPasses = (GAUSSIAN_PASSES * (narrowWidth * narrowWidth + 4.0 * narrowWidth + 3.0) - variance) / (4.0 * narrowWidth + 4.0);
+    const long   passes       = std::min(std::max(std::lround(narrowPasses), 0L), static_cast<long>(GAUSSIAN_PASSES));
+
+    for (int pass = 0; pass < GAUSSIAN_PASSES; ++pass)
+        boxWidths[pass] = (pass < passes) ? (narrowWidth) : (narrowWidth + 2);
+}
+
+// One box pass along a row of width pixels: the row is padded by radius pixels on either side, then a running sum per channel
+// slides across it. The sums are kept in double precision so that adding and taking out the same values never drifts.
+template <size_t Channels>
+static void BoxFilterRow(const float* inputRow, float* outputRow, float* paddedRow, int width, int radius, BorderMode border, float borderValue)
+{
+    for (int index = 0; index < radius; ++index)
+    {
+        const ptrdiff_t leftColumn  = BorderIndex(index - radius, width, border);
+        const ptrdiff_t rightColumn = BorderIndex(width + index, width, border);
+
+        for (size_t channel = 0; channel < Channels; ++channel)
+        {
+            paddedRow[index * Channels + channel]                    = (leftColumn < 0) ? (borderValue) : (inputRow[leftColumn * Channels + channel]);
+            paddedRow[(width + radius + index) * Channels + channel] = (rightColumn < 0) ? (borderValue) : (inputRow[rightColumn * Channels + channel]);
+        }
+    }
+    memcpy(paddedRow + radius * Channels, inputRow, width * Channels * sizeof(float));
+
+    const double inverseWidth         = 1.0 / (2 * radius + 1);
+    double       windowSums[Channels] = {};
+
+    for (int index = 0; index < 2 * radius; ++index)
+        for (size_t channel = 0; channel < Channels; ++channel)
+            windowSums[channel] += paddedRow[index * Channels + channel];
+
+    for (int ix = 0; ix < width; ++ix)
+        for (size_t channel = 0; channel < Channels; ++channel)
+        {
+            windowSums[channel]               += paddedRow[(ix + 2 * radius) * Channels + channel];
+            outputRow[ix * Channels + channel]  = static_cast<float>(windowSums[channel] * inverseWidth);
+            windowSums[channel]               -= paddedRow[ix * Channels + channel];
+        }
+}
+
+// One box pass down the sample columns, row-major like SlidingAveragingBlur: a row of column sums takes one row in and one out
+// per output row. Integer outputs are rounded to nearest.
+template <typename Pixel>
+static void BoxFilterColumns(const BlurImage& inputImage, ImageBuffer<Pixel>& outputImage, int radius, BorderMode border, float borderValue)
+{
+    typedef PixelSample<Pixel> Sample;
+
+    const size_t samples      = inputImage.Width();
+    const int    height       = static_cast<int>(inputImage.Height());
+    const double inverseWidth = 1.0 / (2 * radius + 1);
+    const double rounding     = (std::is_integral<Sample>::value) ? (0.5) : (0.0);
+
+    outputImage.Resize(samples / PixelTraits<Pixel>::CHANNELS, height);
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<double> columnSums(samples);
+
+        std::fill_n(columnSums.Data(), samples, 0.0);
+
+        auto AccumulateRow = [&](ptrdiff_t iy, double sign) {
+            const ptrdiff_t sourceRow = BorderIndex(iy, height, border);
 
-int main(void)
+            if (sourceRow < 0)
+            {
+                for (size_t index = 0; index < samples; ++index)
+                    columnSums[index] += sign * borderValue;
+
+                return;
+            }
+
+            const float* inputRow = inputImage.Row(sourceRow);
+
+            for (size_t index = 0; index < samples; ++index)
+                columnSums[index] += sign * inputRow[index];
+        };
+
+        for (ptrdiff_t iy = static_cast<ptrdiff_t>(bandBegin) - radius; iy < static_cast<ptrdiff_t>(bandBegin) + radius; ++iy)
+            AccumulateRow(iy, 1.0);
+
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            Sample* outputRow = SampleRow(outputImage, iy);
+
+            AccumulateRow(static_cast<ptrdiff_t>(iy) + radius, 1.0);
+            for (size_t index = 0; index < samples; ++index)
+                outputRow[index] = static_cast<Sample>(columnSums[index] * inverseWidth + rounding);
+            AccumulateRow(static_cast<ptrdiff_t>(iy) - radius, -1.0);
+        }
+    }, 4 * (2 * radius + 1));
+}
+
+int GaussianBlurRadius(const float sigma)
 {
-    static const char* INPUT_RAW_FILE_NAME                = "Snow.raw";
-    static const char* OUTPUT_AVG_RAW_FILE_NAME           = "Snow_Avg.raw";
-    static const char* OUTPUT_SEPARABLE_AVG_RAW_FILE_NAME = "Snow_SeparableAvg.raw";
-    static const char* OUTPUT_INTEGRAL_RAW_FILE_NAME      = "Snow_Integral.raw";
-    static const char* OUTPUT_INTEGRAL_AVG_RAW_FILE_NAME  = "Snow_IntegralAvg.raw";
-
-    FILE*   fileStream;
-    int64_t startTime, frequency;
-    float   elapsedTime;
-
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
-
-    CHECK_TIME_START(startTime, frequency);
-    AveragingBlur(inputImage, spatialAveragingImage, 21);
-    CHECK_TIME_END(startTime, frequency, elapsedTime);
-    printf("[Averaging Blur] %fms\n", elapsedTime);
-
-    CHECK_TIME_START(startTime, frequency);
-    SeparableAveragingBlur(inputImage, separableSpatialAveragingImage, 21);
-    CHECK_TIME_END(startTime, frequency, elapsedTime);
-    printf("[Separable Averaging Blur] %fms\n", elapsedTime);
-
-    CreateIntegralImage(inputImage, integralImage);
-    NormalizationIntegralImage(integralImage, normalizationIntegralImage);
-
-    CHECK_TIME_START(startTime, frequency);
-    IntegralAveragingBlur(inputImage, integralImage, integralSpatialAveragingImage, 21);
-    CHECK_TIME_END(startTime, frequency, elapsedTime);
-    printf("[Integral Averaging Blur] %fms\n", elapsedTime);
-
-    fileStream = fopen(OUTPUT_AVG_RAW_FILE_NAME, "w+b");
-    fwrite(spatialAveragingImage, sizeof(spatialAveragingImage), 1, fileStream);
-    fclose(fileStream);
-
-    fileStream = fopen(OUTPUT_SEPARABLE_AVG_RAW_FILE_NAME, "w+b");
-    fwrite(separableSpatialAveragingImage, sizeof(separableSpatialAveragingImage), 1, fileStream);
-    fclose(fileStream);
-
-    fileStream = fopen(OUTPUT_INTEGRAL_RAW_FILE_NAME, "w+b");
-    fwrite(normalizationIntegralImage, sizeof(normalizationIntegralImage), 1, fileStream);
-    fclose(fileStream);
-
-    fileStream = fopen(OUTPUT_INTEGRAL_AVG_RAW_FILE_NAME, "w+b");
-    fwrite(integralSpatialAveragingImage, sizeof(integralSpatialAveragingImage), 1, fileStream);
-    fclose(fileStream);
-
-    return 0;
+    int boxWidths[GAUSSIAN_PASSES];
+    int radius = 0;
+
+    CreateGaussianBoxWidths(sigma, boxWidths);
+    for (int pass = 0; pass < GAUSSIAN_PASSES; ++pass)
+        radius += boxWidths[pass] / 2;
+
+    return radius;
 }
 
+template <typename Pixel>
+ImageBuffer<Pixel>& GaussianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const float sigma, BorderMode border,
+                                 PixelSample<Pixel> borderValue)
+{
+    TraceScope trace("GaussianBlur", inputImage, outputImage);
+
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    assert(&inputImage != &outputImage);
+    assert(sigma >= 0.0F);
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+
+    int       boxWidths[GAUSSIAN_PASSES];
+    const int radius = GaussianBlurRadius(sigma);
+
+    CreateGaussianBoxWidths(sigma, boxWidths);
+
+    // NONE keeps the input on the frame the combined window cannot cover, so any border mode serves for the passes themselves
+    if (inputImage.IsEmpty() || (border == BorderMode::NONE && (2 * radius + 1 > width || 2 * radius + 1 > height)))
+        return CopyImage(inputImage, outputImage);
+
+    const BorderMode passBorder = (border == BorderMode::NONE) ? (BorderMode::REPLICATE) : (border);
+    ScratchImage<float> rowsImage(width * CHANNELS, height);
+    ScratchImage<float> columnsImage(width * CHANNELS, height);
+
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        ScratchBuffer<float> firstRow(width * CHANNELS);
+        ScratchBuffer<float> secondRow(width * CHANNELS);
+        ScratchBuffer<float> paddedRow((width + boxWidths[GAUSSIAN_PASSES - 1] - 1) * CHANNELS);
+
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            std::copy(SampleRow(inputImage, iy), SampleRow(inputImage, iy) + width * CHANNELS, firstRow.Data());
+
+            BoxFilterRow<CHANNELS>(firstRow.Data(), secondRow.Data(), paddedRow.Data(), width, boxWidths[0] / 2, passBorder, borderValue);
+            BoxFilterRow<CHANNELS>(secondRow.Data(), firstRow.Data(), paddedRow.Data(), width, boxWidths[1] / 2, passBorder, borderValue);
+            BoxFilterRow<CHANNELS>(firstRow.Data(), rowsImage.Row(iy), paddedRow.Data(), width, boxWidths[2] / 2, passBorder, borderValue);
+        }
+    });
+
+    BoxFilterColumns(rowsImage, columnsImage, boxWidths[0] / 2, passBorder, borderValue);
+    BoxFilterColumns(columnsImage, rowsImage, boxWidths[1] / 2, passBorder, borderValue);
+    BoxFilterColumns(rowsImage, outputImage, boxWidths[2] / 2, passBorder, borderValue);
+
+    if (border == BorderMode::NONE)
+        for (int iy = 0; iy < height; ++iy)
+        {
+            if (iy < radius || iy >= height - radius)
+            {
+                memcpy(outputImage.Row(iy), inputImage.Row(iy), width * sizeof(Pixel));
+                continue;
+            }
+
+            memcpy(outputImage.Row(iy), inputImage.Row(iy), radius * sizeof(Pixel));
+            memcpy(outputImage.Row(iy) + width - radius, inputImage.Row(iy) + width - radius, radius * sizeof(Pixel));
+        }
+
+    return outputImage;
+}
+
+template Image&     GaussianBlur(const Image&, Image&, const float, BorderMode, byte_t);
+template WideImage& GaussianBlur(const WideImage&, WideImage&, const float, BorderMode, wbyte_t);
+template RGBImage&  GaussianBlur(const RGBImage&, RGBImage&, const float, BorderMode, byte_t);
+template RGBAImage& GaussianBlur(const RGBAImage&, RGBAImage&, const float, BorderMode, byte_t);
+
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,50 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef SPATIAL_AVERAGING_H
+#define SPATIAL_AVERAGING_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Border Mode.h"
+#include "Image.h"
+
+// +-------------------------------------------< AVERAGING BLUR >-------------------------------------------+
+
+// The windowed filters below leave a wsize / 2 frame of input pixels under NONE; any other border lets the windows reach beyond the
+// image, filtering the frame through padded edge strips while the interior loops stay untouched
+Image& AveragingBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border = BorderMode::NONE, byte_t borderValue = 0);
+
+Image& SeparableAveragingBlur(const Image& inputImage, Image& outputImage, const int wsize, BorderMode border = BorderMode::NONE, byte_t borderValue = 0);
+
+IntegralImage& CreateIntegralImage(const Image& inputImage, IntegralImage& integralImage);
+
+// Scales the integral image to 0 ... 255 for display
+Image& NormalizationIntegralImage(const IntegralImage& integralImage, Image& normalizationIntegralImage);
+
+Image& IntegralAveragingBlur(const Image& inputImage, const IntegralImage& integralImage, Image& outputImage, const int wsize,
+                             BorderMode border = BorderMode::NONE, byte_t borderValue = 0);
+
+// +---------------------------------------< SLIDING AVERAGING BLUR >---------------------------------------+
+
+// The wsize x wsize box average with running sums: one row of 32-bit column sums slides down the image and a window sum slides
+// along each row, so the cost per pixel does not depend on wsize and no integral image is needed. The windows reach beyond the
+// image through border; NONE gives exactly the IntegralAveragingBlur result. wsize is at most 4103.
+template <typename Pixel>
+ImageBuffer<Pixel>& SlidingAveragingBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const int wsize,
+                                         BorderMode border = BorderMode::REPLICATE, PixelSample<Pixel> borderValue = 0);
+
+// +-------------------------------------------< GAUSSIAN BLUR >--------------------------------------------+
+
+// Approximates the Gaussian of the given sigma by three stacked box filters whose widths are matched to its variance, each run as
+// a running sum along the rows and then down the columns in single precision. The cost per pixel does not depend on sigma. Every
+// pass reaches beyond the image through border; NONE keeps the input wherever the combined window would leave the image.
+template <typename Pixel>
+ImageBuffer<Pixel>& GaussianBlur(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const float sigma,
+                                 BorderMode border = BorderMode::REPLICATE, PixelSample<Pixel> borderValue = 0);
+
+// The rows and columns a GaussianBlur of sigma reaches on either side of a pixel, the sum of the radii of its three boxes
+int GaussianBlurRadius(const float sigma);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,170 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Histogram Equalization.h"
+#include "Instrumentation.h"
+#include "Mapped Image.h"
+#include "Median Blur.h"
+#include "Spatial Averaging.h"
+#include "Strip Processing.h"
+
+// +------------------------------------------< STRIP PROCESSING >------------------------------------------+
+
+// Large enough to keep every worker busy and amortize the per-strip setup, small enough that a strip and its scratch stay cheap
+static const size_t STRIP_PIXELS = 1 << 22;
+
+static size_t ChooseStripHeight(size_t width, size_t height, size_t halo, size_t stripHeight)
+{
+    // A strip much shorter than its halo would spend most of its time on rows that belong to its neighbours
+    if (stripHeight == 0)
+        stripHeight = std::max(8 * halo, STRIP_PIXELS / std::max<size_t>(width, 1));
+
+    return std::min(std::max<size_t>(stripHeight, 1), height);
+}
+
+// +-------------------------------------------< WINDOWED STRIP >-------------------------------------------+
+
+// Runs filter over rows rowBegin - halo ... rowEnd + halo - 1 of every strip, clipped to the image. A row that is a border row of
+// the clipped view is a border row of the whole image too, so the filter treats the borders exactly as on the full image.
+// The filters write their own border rows, which are this strip's halo, so the result goes through a strip-sized scratch image and
+// only the strip's own rows are copied out; writing the view straight into the output would overwrite rows its neighbours own.
+template <typename Filter>
+static bool ProcessWindowedStrips(const char* inputFileName, const char* outputFileName, size_t width, size_t height, size_t halo, size_t stripHeight, Filter filter)
+{
+    MappedImage inputImage;
+    MappedImage outputImage;
+
+    if (!inputImage.OpenRead(inputFileName, width, height) || !outputImage.Create(outputFileName, width, height))
+        return false;
+
+    stripHeight = ChooseStripHeight(width, height, halo, stripHeight);
+
+    Image  stripImage;
+    size_t releasedRows = 0;
+
+    for (size_t rowBegin = 0; rowBegin < height; rowBegin += stripHeight)
+    {
+        const size_t rowEnd    = std::min(height, rowBegin + stripHeight);
+        const size_t viewBegin = (rowBegin > halo) ? (rowBegin - halo) : (0);
+        const size_t viewEnd   = std::min(height, rowEnd + halo);
+
+        filter(inputImage.GetRows(viewBegin, viewEnd), stripImage);
+
+        Image outputRows = outputImage.GetRows(rowBegin, rowEnd);
+
+        for (size_t iy = rowBegin; iy < rowEnd; ++iy)
+            memcpy(outputRows.Row(iy - rowBegin), stripImage.Row(iy - viewBegin), width);
+
+        // The next strip reaches back halo rows, everything above that is never read again
+        const size_t finishedRows = (rowEnd > halo) ? (rowEnd - halo) : (0);
+
+        if (finishedRows > releasedRows)
+        {
+            inputImage.Release(releasedRows, finishedRows);
+            releasedRows = finishedRows;
+        }
+        outputImage.Release(rowBegin, rowEnd);
+    }
+
+    return true;
+}
+
+bool StripIntegralAveragingBlur(const char* inputFileName, const char* outputFileName, size_t width, size_t height, const int wsize, size_t stripHeight)
+{
+    TraceScope trace("StripIntegralAveragingBlur");
+
+    trace.AddTraffic(width * height, width * height, width * height);
+
+    assert(wsize > 0);
+
+    IntegralImage integralImage;
+
+    // Strip-relative integral rows leave every box sum unchanged, the rows above the strip would only add a constant that cancels
+    return ProcessWindowedStrips(inputFileName, outputFileName, width, height, wsize / 2, stripHeight, [&](const Image& inputImage, Image& outputImage) {
+        IntegralAveragingBlur(inputImage, CreateIntegralImage(inputImage, integralImage), outputImage, wsize);
+    });
+}
+
+bool StripSeparableMedianBlur(const char* inputFileName, const char* outputFileName, size_t width, size_t height, const int wsize, size_t stripHeight)
+{
+    TraceScope trace("StripSeparableMedianBlur");
+
+    trace.AddTraffic(width * height, width * height, width * height);
+
+    assert(wsize > 0);
+
+    return ProcessWindowedStrips(inputFileName, outputFileName, width, height, wsize / 2, stripHeight, [&](const Image& inputImage, Image& outputImage) {
+        SeparableMedianBlur(inputImage, outputImage, wsize);
+    });
+}
+
+// +------------------------------------------< HISTOGRAM STRIP >-------------------------------------------+
+
+// Point operations need no halo and write exactly the rows they read, so the strips map input to output without any scratch image
+template <typename Mapping>
+static bool ProcessHistogramStrips(const char* inputFileName, const char* outputFileName, size_t width, size_t height, size_t stripHeight, Mapping mapping)
+{
+    MappedImage inputImage;
+    MappedImage outputImage;
+
+    if (!inputImage.OpenRead(inputFileName, width, height) || !outputImage.Create(outputFileName, width, height))
+        return false;
+
+    stripHeight = ChooseStripHeight(width, height, 0, stripHeight);
+
+    Histogram histogram = {};
+
+    for (size_t rowBegin = 0; rowBegin < height; rowBegin += stripHeight)
+    {
+        const size_t rowEnd = std::min(height, rowBegin + stripHeight);
+
+        AccumulateHistogram(inputImage.GetRows(rowBegin, rowEnd), histogram);
+        inputImage.Release(rowBegin, rowEnd);
+    }
+
+    for (size_t rowBegin = 0; rowBegin < height; rowBegin += stripHeight)
+    {
+        const size_t rowEnd = std::min(height, rowBegin + stripHeight);
+
+        Image outputRows = outputImage.GetRows(rowBegin, rowEnd);
+
+        mapping(inputImage.GetRows(rowBegin, rowEnd), outputRows, histogram);
+        inputImage.Release(rowBegin, rowEnd);
+        outputImage.Release(rowBegin, rowEnd);
+    }
+
+    return true;
+}
+
+bool StripHistogramEqualization(const char* inputFileName, const char* outputFileName, size_t width, size_t height, size_t stripHeight)
+{
+    TraceScope trace("StripHistogramEqualization");
+
+    trace.AddTraffic(width * height, 2 * width * height, width * height);
+
+    return ProcessHistogramStrips(inputFileName, outputFileName, width, height, stripHeight, [](const Image& inputImage, Image& outputImage, const Histogram& histogram) {
+        HistogramEqualization(inputImage, outputImage, histogram);
+    });
+}
+
+bool StripHistogramSpecification(const char* inputFileName, const char* outputFileName, size_t width, size_t height, BOI boi, const byte_t maxBrightness, size_t stripHeight)
+{
+    TraceScope trace("StripHistogramSpecification");
+
+    trace.AddTraffic(width * height, 2 * width * height, width * height);
+
+    return ProcessHistogramStrips(inputFileName, outputFileName, width, height, stripHeight, [&](const Image& inputImage, Image& outputImage, const Histogram& histogram) {
+        HistogramSpecification(inputImage, outputImage, histogram, boi, maxBrightness);
+    });
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,34 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef STRIP_PROCESSING_H
+#define STRIP_PROCESSING_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstddef>
+
+#include "Histogram Specification.h"
+
+// +------------------------------------------< STRIP PROCESSING >------------------------------------------+
+
+// File to file variants of the filters for raw images too large to hold in memory. Both files are memory-mapped and the image is
+// walked in strips of stripHeight rows, 0 choosing about four megapixels per strip, and every finished strip is released from
+// the resident set. The results equal the in-memory filters, and false is returned when a file cannot be opened or mapped.
+
+// +-------------------------------------------< WINDOWED STRIP >-------------------------------------------+
+
+// Each strip is filtered together with the wsize / 2 halo rows above and below it that its windows reach into
+bool StripIntegralAveragingBlur(const char* inputFileName, const char* outputFileName, size_t width, size_t height, const int wsize, size_t stripHeight = 0);
+
+bool StripSeparableMedianBlur(const char* inputFileName, const char* outputFileName, size_t width, size_t height, const int wsize, size_t stripHeight = 0);
+
+// +------------------------------------------< HISTOGRAM STRIP >-------------------------------------------+
+
+// One pass counts the histogram of the whole file, a second maps every strip straight from the input to the output mapping
+bool StripHistogramEqualization(const char* inputFileName, const char* outputFileName, size_t width, size_t height, size_t stripHeight = 0);
+
+bool StripHistogramSpecification(const char* inputFileName, const char* outputFileName, size_t width, size_t height, BOI boi = BOI::DARKNESS, const byte_t maxBrightness = 255, size_t stripHeight = 0);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,375 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Image Processing.h"
+#include "Test.h"
+
+// The operations that promise the same result as another path through the library: fused graphs, file strips, the batch
+// pipeline, the service and the video histograms are all checked against plain calls of the operations they stand for
+
+// +-----------------------------------------------< CHAIN >------------------------------------------------+
+
+static Image RunChain(const OperationChain& chain, const Image& inputImage)
+{
+    Image image(inputImage);
+    Image outputImage;
+
+    for (const BatchOperation& operation : chain)
+    {
+        operation(image, outputImage);
+        image.Swap(outputImage);
+    }
+
+    return image;
+}
+
+// +------------------------------------------< OPERATION GRAPH >-------------------------------------------+
+
+static void TestOperationGraph(std::mt19937& random)
+{
+    byte_t invertLUT[256];
+    byte_t thresholdLUT[256];
+
+    for (int brightness = 0; brightness < 256; ++brightness)
+    {
+        invertLUT[brightness]    = static_cast<byte_t>(255 - brightness);
+        thresholdLUT[brightness] = (brightness < 128) ? (0) : (255);
+    }
+
+    struct GraphCase
+    {
+        OperationGraph graph;
+        OperationChain chain;
+    };
+
+    std::vector<GraphCase> cases(7);
+
+    cases[0].graph.ApplyLUT(invertLUT).Equalize();
+    cases[0].chain = { [&](const Image& inputImage, Image& outputImage) { ApplyBrightnessLUT(inputImage, outputImage, invertLUT); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); } };
+
+    cases[1].graph.GaussianBlur(1.5F).Equalize().AveragingBlur(5).Specify(BOI::LIGHTNESS);
+    cases[1].chain = { [](const Image& inputImage, Image& outputImage) { GaussianBlur(inputImage, outputImage, 1.5F); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); },
+                       [](const Image& inputImage, Image& outputImage) { SlidingAveragingBlur(inputImage, outputImage, 5); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramSpecification(inputImage, outputImage, BOI::LIGHTNESS); } };
+
+    cases[2].graph.MedianBlur(5).ApplyLUT(invertLUT).AveragingBlur(3, BorderMode::REFLECT).UnsharpMasking(1.0F);
+    cases[2].chain = { [](const Image& inputImage, Image& outputImage) { HistogramMedianBlur(inputImage, outputImage, 5); },
+                       [&](const Image& inputImage, Image& outputImage) { ApplyBrightnessLUT(inputImage, outputImage, invertLUT); },
+                       [](const Image& inputImage, Image& outputImage) { SlidingAveragingBlur(inputImage, outputImage, 3, BorderMode::REFLECT); },
+                       [](const Image& inputImage, Image& outputImage) { GaussianUnsharpMasking(inputImage, outputImage, 1.0F); } };
+
+    cases[3].graph.AdaptiveMedianBlur(7, BorderMode::REPLICATE).MedianBlur(3, BorderMode::WRAP).Equalize();
+    cases[3].chain = { [](const Image& inputImage, Image& outputImage) { AdaptiveMedianBlur(inputImage, outputImage, 7, BorderMode::REPLICATE); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramMedianBlur(inputImage, outputImage, 3, BorderMode::WRAP); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); } };
+
+    cases[4].graph.AveragingBlur(15, BorderMode::NONE).GaussianBlur(3.0F, BorderMode::WRAP).GaussianBlur(0.8F, BorderMode::CONSTANT);
+    cases[4].chain = { [](const Image& inputImage, Image& outputImage) { SlidingAveragingBlur(inputImage, outputImage, 15, BorderMode::NONE); },
+                       [](const Image& inputImage, Image& outputImage) { GaussianBlur(inputImage, outputImage, 3.0F, BorderMode::WRAP); },
+                       [](const Image& inputImage, Image& outputImage) { GaussianBlur(inputImage, outputImage, 0.8F, BorderMode::CONSTANT); } };
+
+    cases[5].graph.Specify().Equalize().ApplyLUT(thresholdLUT, "Threshold");
+    cases[5].chain = { [](const Image& inputImage, Image& outputImage) { HistogramSpecification(inputImage, outputImage); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); },
+                       [&](const Image& inputImage, Image& outputImage) { ApplyBrightnessLUT(inputImage, outputImage, thresholdLUT); } };
+
+    cases[6].graph.Convolve(ConvolutionKernel::Sobel(true, 128.0F)).Equalize().Convolve(ConvolutionKernel::Laplacian(128.0F), BorderMode::REFLECT);
+    cases[6].chain = { [](const Image& inputImage, Image& outputImage) { Convolve(inputImage, outputImage, ConvolutionKernel::Sobel(true, 128.0F)); },
+                       [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); },
+                       [](const Image& inputImage, Image& outputImage) { Convolve(inputImage, outputImage, ConvolutionKernel::Laplacian(128.0F), BorderMode::REFLECT); } };
+
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        const size_t width      = 1 + random() % 300;
+        const size_t height     = 1 + random() % 300;
+        Image        inputImage = CreateNaturalImage(width, height, random);
+
+        CreateSaltAndPepperNoise(inputImage, inputImage, 0.05F, random());
+
+        for (size_t index = 0; index < cases.size(); ++index)
+            for (const size_t threadCount : { 1, 4 })
+            {
+                Image outputImage;
+
+                SetThreadCount(threadCount);
+                cases[index].graph.Evaluate(inputImage, outputImage);
+
+                CheckImage("OperationGraph", "case " + std::to_string(index) + ": " + cases[index].graph.Describe() + ", " + std::to_string(width) + "x" +
+                           std::to_string(height) + ", " + std::to_string(threadCount) + " threads", RunChain(cases[index].chain, inputImage), outputImage);
+            }
+    }
+
+    // Convolve picks its method by the image size. A dense 41 x 41 kernel takes the FFT on 1024 x 512 but runs directly on the tiles
+    // of a quarter of that, so a fused stage has to keep the method of the whole image to match.
+    std::vector<float> denseWeights(41 * 41);
+
+    for (size_t index = 0; index < denseWeights.size(); ++index)
+        denseWeights[index] = static_cast<float>((index * 37) % 11 + 1) / (6.0F * denseWeights.size());
+
+    const ConvolutionKernel denseKernel(41, 41, denseWeights.data());
+    const Image             inputImage = CreateNaturalImage(1024, 512, random);
+    OperationGraph          graph;
+    OperationChain          chain = { [&](const Image& inputImage, Image& outputImage) { Convolve(inputImage, outputImage, denseKernel, BorderMode::REFLECT); },
+                                      [](const Image& inputImage, Image& outputImage) { Convolve(inputImage, outputImage, ConvolutionKernel::Gaussian(2.0F)); } };
+
+    graph.Convolve(denseKernel, BorderMode::REFLECT).Convolve(ConvolutionKernel::Gaussian(2.0F));
+
+    for (const size_t threadCount : { 1, 4 })
+    {
+        Image outputImage;
+
+        SetThreadCount(threadCount);
+        graph.Evaluate(inputImage, outputImage);
+
+        CheckImage("OperationGraph", "dense convolution: " + graph.Describe() + ", 1024x512, " + std::to_string(threadCount) + " threads", RunChain(chain, inputImage),
+                   outputImage);
+    }
+}
+
+// +------------------------------------------< STRIP PROCESSING >------------------------------------------+
+
+static void TestStripProcessing(std::mt19937& random)
+{
+    static const char* INPUT_FILE_NAME  = "Consistency_Input.raw";
+    static const char* OUTPUT_FILE_NAME = "Consistency_Output.raw";
+
+    SetThreadCount(0);
+
+    for (int iteration = 0; iteration < 4; ++iteration)
+    {
+        const size_t width      = 1 + random() % 200;
+        const size_t height     = 1 + random() % 200;
+        const Image  inputImage = CreateNaturalImage(width, height, random);
+        Image        expectedImage, outputImage;
+
+        if (!Check("WriteRawImage", INPUT_FILE_NAME, WriteRawImage(INPUT_FILE_NAME, inputImage)))
+            return;
+
+        for (const size_t stripHeight : { size_t(0), size_t(1), size_t(2), size_t(7), 1 + random() % height })
+        {
+            const std::string detail = std::to_string(width) + "x" + std::to_string(height) + ", strips of " + std::to_string(stripHeight);
+            const int         wsize  = 1 + 2 * (random() % 6);
+
+            const auto checkOutput = [&](const char* operation, const std::string& operationDetail, bool written) {
+                if (Check(operation, operationDetail + ", written", written) && Check(operation, operationDetail + ", read", ReadRawImage(OUTPUT_FILE_NAME, outputImage, width, height)))
+                    CheckImage(operation, operationDetail, expectedImage, outputImage);
+            };
+
+            IntegralImage integralImage;
+
+            IntegralAveragingBlur(inputImage, CreateIntegralImage(inputImage, integralImage), expectedImage, wsize);
+            checkOutput("StripIntegralAveragingBlur", detail + ", wsize " + std::to_string(wsize),
+                        StripIntegralAveragingBlur(INPUT_FILE_NAME, OUTPUT_FILE_NAME, width, height, wsize, stripHeight));
+
+            SeparableMedianBlur(inputImage, expectedImage, wsize);
+            checkOutput("StripSeparableMedianBlur", detail + ", wsize " + std::to_string(wsize),
+                        StripSeparableMedianBlur(INPUT_FILE_NAME, OUTPUT_FILE_NAME, width, height, wsize, stripHeight));
+
+            HistogramEqualization(inputImage, expectedImage);
+            checkOutput("StripHistogramEqualization", detail, StripHistogramEqualization(INPUT_FILE_NAME, OUTPUT_FILE_NAME, width, height, stripHeight));
+
+            HistogramSpecification(inputImage, expectedImage, BOI::LIGHTNESS, 200);
+            checkOutput("StripHistogramSpecification", detail + ", LIGHTNESS 200",
+                        StripHistogramSpecification(INPUT_FILE_NAME, OUTPUT_FILE_NAME, width, height, BOI::LIGHTNESS, 200, stripHeight));
+        }
+    }
+
+    std::remove(INPUT_FILE_NAME);
+    std::remove(OUTPUT_FILE_NAME);
+}
+
+// +-------------------------------------------< BATCH PIPELINE >-------------------------------------------+
+
+static void TestBatchPipeline(std::mt19937& random)
+{
+    static const size_t FRAMES = 6;
+
+    const OperationChain chain = { [](const Image& inputImage, Image& outputImage) { HistogramMedianBlur(inputImage, outputImage, 3); },
+                                   [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); },
+                                   [](const Image& inputImage, Image& outputImage) { ZeroOrderInterpolator(inputImage, outputImage, 2); } };
+
+    std::vector<BatchFrame> frames;
+    std::vector<Image>      inputImages;
+
+    for (size_t index = 0; index < FRAMES; ++index)
+    {
+        const std::string name = "Consistency_Frame" + std::to_string(index);
+
+        frames.push_back({ name + ".raw", name + "_Output.raw", 1 + random() % 120, 1 + random() % 120 });
+        inputImages.push_back(CreateNaturalImage(frames.back().width, frames.back().height, random));
+
+        if (!Check("WriteRawImage", frames.back().inputFileName, WriteRawImage(frames.back().inputFileName.c_str(), inputImages.back())))
+            return;
+    }
+
+    // A frame missing on disk fails alone without stopping the others
+    frames.push_back({ "Consistency_Missing.raw", "Consistency_Missing_Output.raw", 16, 16 });
+
+    const std::vector<size_t> failures = RunBatchPipeline(frames, chain, 2);
+
+    Check("RunBatchPipeline", "failed frames", failures == std::vector<size_t>(1, FRAMES));
+
+    for (size_t index = 0; index < FRAMES; ++index)
+    {
+        Image outputImage;
+
+        if (Check("RunBatchPipeline", frames[index].outputFileName + ", read", ReadRawImage(frames[index].outputFileName.c_str(), outputImage, 2 * frames[index].width, 2 * frames[index].height)))
+            CheckImage("RunBatchPipeline", frames[index].outputFileName, RunChain(chain, inputImages[index]), outputImage);
+
+        std::remove(frames[index].inputFileName.c_str());
+        std::remove(frames[index].outputFileName.c_str());
+    }
+}
+
+// +-------------------------------------------< IMAGE SERVICE >--------------------------------------------+
+
+// Several clients submitting at once, small images batched and large ones in bands, against the chain run on its own
+static void TestImageService(std::mt19937& random)
+{
+    static const size_t CLIENTS  = 3;
+    static const size_t REQUESTS = 24;
+
+    const std::shared_ptr<const OperationChain> chain = std::make_shared<const OperationChain>(OperationChain{
+        [](const Image& inputImage, Image& outputImage) { SlidingAveragingBlur(inputImage, outputImage, 3); },
+        [](const Image& inputImage, Image& outputImage) { HistogramEqualization(inputImage, outputImage); },
+        [](const Image& inputImage, Image& outputImage) { Resample(inputImage, outputImage, inputImage.Width() / 2 + 1, inputImage.Height() + 3); } });
+
+    ServiceSettings settings;
+
+    settings.workerCount   = 3;
+    settings.queueCapacity = 8;
+    settings.smallPixels   = 64 * 64;
+    settings.batchPixels   = 4 * 64 * 64;
+
+    SetThreadCount(4);
+
+    std::vector<Image> inputImages;
+
+    for (size_t index = 0; index < CLIENTS * REQUESTS; ++index)
+    {
+        const size_t size = (random() % 4 == 0) ? (1 + random() % 200) : (1 + random() % 64);
+
+        inputImages.push_back(CreateNaturalImage(size, 1 + random() % 64, random));
+    }
+
+    std::vector<Image> outputImages(inputImages.size());
+
+    {
+        ImageService             service(settings);
+        std::vector<std::thread> clients;
+
+        for (size_t client = 0; client < CLIENTS; ++client)
+            clients.emplace_back([&, client]() {
+                std::vector<std::future<ServiceResult>> results;
+
+                for (size_t request = 0; request < REQUESTS; ++request)
+                    results.push_back(service.Submit(inputImages[client * REQUESTS + request], chain));
+                for (size_t request = 0; request < REQUESTS; ++request)
+                    outputImages[client * REQUESTS + request] = results[request].get().image;
+            });
+
+        for (std::thread& client : clients)
+            client.join();
+
+        // A request counts as completed only once its callback has returned, which may be after its future is ready
+        const ServiceStatistics statistics = service.GetStatistics();
+
+        Check("ImageService", "requests submitted", statistics.submitted == inputImages.size() && statistics.rejected == 0 && statistics.completed <= statistics.submitted);
+    }
+
+    for (size_t index = 0; index < inputImages.size(); ++index)
+        CheckImage("ImageService", "request " + std::to_string(index) + ", " + std::to_string(inputImages[index].Width()) + "x" + std::to_string(inputImages[index].Height()),
+                   RunChain(*chain, inputImages[index]), outputImages[index]);
+}
+
+// +-----------------------------------------< HISTOGRAM SEQUENCE >-----------------------------------------+
+
+// Without smoothing or a threshold every frame gets exactly its own table, however many tiles are carried over from the previous one
+static void TestHistogramSequence(std::mt19937& random)
+{
+    const size_t width          = 150 + random() % 100;
+    const size_t height         = 100 + random() % 100;
+    const Image  backgroundImage = CreateNaturalImage(width, height, random);
+
+    HistogramSequence equalization  = HistogramSequence::Equalization();
+    HistogramSequence specification = HistogramSequence::Specification(BOI::LIGHTNESS);
+
+    for (size_t frame = 0; frame < 12; ++frame)
+    {
+        // A bright block moving across a still background, standing still every third frame
+        Image        frameImage(backgroundImage);
+        const size_t left = std::min(width - 1, (frame - frame / 3) * 9);
+
+        for (size_t iy = height / 4; iy < height / 2; ++iy)
+            for (size_t ix = left; ix < std::min(width, left + 40); ++ix)
+                frameImage(ix, iy) = 230;
+
+        const std::string detail = std::to_string(width) + "x" + std::to_string(height) + ", frame " + std::to_string(frame);
+        Image             expectedImage, outputImage;
+
+        CheckImage("HistogramSequence::Equalization", detail, HistogramEqualization(frameImage, expectedImage), equalization.Process(frameImage, outputImage));
+        CheckImage("HistogramSequence::Specification", detail, HistogramSpecification(frameImage, expectedImage, BOI::LIGHTNESS),
+                   specification.Process(frameImage, outputImage));
+
+        if (frame == 7)
+            equalization.Reset();
+    }
+
+    Check("HistogramSequence::Equalization", "tiles carried over", equalization.GetStatistics().tilesCarried > 0);
+}
+
+// +------------------------------------------< SALT AND PEPPER >-------------------------------------------+
+
+// The noise depends on the seed only: not on the thread count, and not on whether it is made in place
+static void TestSaltAndPepperNoise(std::mt19937& random)
+{
+    const Image    inputImage = CreateNaturalImage(1 + random() % 300, 1 + random() % 300, random);
+    const uint64_t seed       = random();
+    Image          serialImage, parallelImage, otherImage, inPlaceImage(inputImage);
+
+    SetThreadCount(1);
+    CreateSaltAndPepperNoise(inputImage, serialImage, 0.1F, seed);
+    SetThreadCount(4);
+    CreateSaltAndPepperNoise(inputImage, parallelImage, 0.1F, seed);
+    CreateSaltAndPepperNoise(inPlaceImage, inPlaceImage, 0.1F, seed);
+
+    CheckImage("CreateSaltAndPepperNoise", "threads, seed " + std::to_string(seed), serialImage, parallelImage);
+    CheckImage("CreateSaltAndPepperNoise", "in place, seed " + std::to_string(seed), serialImage, inPlaceImage);
+
+    size_t differences = 0;
+
+    CreateSaltAndPepperNoise(inputImage, otherImage, 0.1F, seed + 1);
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+            differences += (serialImage(ix, iy) != otherImage(ix, iy)) ? (1) : (0);
+
+    Check("CreateSaltAndPepperNoise", "another seed, another noise", inputImage.Width() * inputImage.Height() < 100 || differences > 0);
+    CheckImage("CreateSaltAndPepperNoise", "ratio 0", inputImage, CreateSaltAndPepperNoise(inputImage, otherImage, 0.0F, seed));
+}
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main()
+{
+    std::mt19937 random(1);
+
+    TestOperationGraph(random);
+    TestStripProcessing(random);
+    TestBatchPipeline(random);
+    TestImageService(random);
+    TestHistogramSequence(random);
+    TestSaltAndPepperNoise(random);
+
+    return PrintCheckSummary();
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,705 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Border Mode.h"
+#include "Convolution.h"
+#include "Histogram Specification.h"
+#include "Image.h"
+#include "Resampler.h"
+
+// Straight per-pixel definitions of the library operations: every output sample is computed on its own from the input, with the
+// border mode applied per sample, no running sums, no bands and no SIMD. They are slow and meant to stay obviously right.
+
+// +-----------------------------------------------< SAMPLE >-----------------------------------------------+
+
+// Sample (ix, iy) of one channel, the border mode filling in the outside; NONE replicates, callers only ask it for inside samples
+template <typename Pixel>
+PixelSample<Pixel> ReferenceSample(const ImageBuffer<Pixel>& image, ptrdiff_t ix, ptrdiff_t iy, size_t channel, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    const BorderMode sourceBorder = (border == BorderMode::NONE) ? (BorderMode::REPLICATE) : (border);
+    const ptrdiff_t  column       = BorderIndex(ix, image.Width(), sourceBorder);
+    const ptrdiff_t  row          = BorderIndex(iy, image.Height(), sourceBorder);
+
+    if (column < 0 || row < 0)
+        return borderValue;
+
+    return SampleRow(image, row)[column * PixelTraits<Pixel>::CHANNELS + channel];
+}
+
+// Whether NONE keeps the input at (ix, iy) because the window does not fit around it
+inline bool IsFramePixel(size_t ix, size_t iy, size_t width, size_t height, int radius)
+{
+    return static_cast<ptrdiff_t>(ix) < radius || static_cast<ptrdiff_t>(ix) >= static_cast<ptrdiff_t>(width) - radius ||
+           static_cast<ptrdiff_t>(iy) < radius || static_cast<ptrdiff_t>(iy) >= static_cast<ptrdiff_t>(height) - radius;
+}
+
+// +-------------------------------------------< AVERAGING BLUR >-------------------------------------------+
+
+// The window mean rounded down; NONE keeps the input where the window does not fit
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceAveragingBlur(const ImageBuffer<Pixel>& inputImage, int wsize, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    ImageBuffer<Pixel> outputImage(inputImage);
+    const int          radius = wsize / 2;
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+        {
+            if (border == BorderMode::NONE && IsFramePixel(ix, iy, inputImage.Width(), inputImage.Height(), radius))
+                continue;
+
+            for (size_t channel = 0; channel < CHANNELS; ++channel)
+            {
+                uint64_t sum = 0;
+
+                for (int dy = -radius; dy <= radius; ++dy)
+                    for (int dx = -radius; dx <= radius; ++dx)
+                        sum += ReferenceSample(inputImage, ix + dx, iy + dy, channel, border, borderValue);
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>(sum / (static_cast<uint64_t>(wsize) * wsize));
+            }
+        }
+
+    return outputImage;
+}
+
+// A column mean rounded down, then a row mean of those rounded down. Under NONE the column means cover every column of the rows
+// the window fits in, and the input stays on the frame.
+inline Image ReferenceSeparableAveragingBlur(const Image& inputImage, int wsize, BorderMode border, byte_t borderValue)
+{
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+    const int radius = wsize / 2;
+    Image     outputImage(inputImage);
+
+    if (border == BorderMode::NONE && (wsize > width || wsize > height))
+        return outputImage;
+
+    const auto columnMean = [&](int ix, int iy) {
+        int sum = 0;
+
+        for (int dy = -radius; dy <= radius; ++dy)
+            sum += ReferenceSample(inputImage, ix, iy + dy, 0, border, borderValue);
+
+        return sum / wsize;
+    };
+
+    for (int iy = 0; iy < height; ++iy)
+        for (int ix = 0; ix < width; ++ix)
+        {
+            if (border == BorderMode::NONE && IsFramePixel(ix, iy, width, height, radius))
+                continue;
+
+            int sum = 0;
+
+            for (int dx = -radius; dx <= radius; ++dx)
+                sum += columnMean(ix + dx, iy);
+
+            outputImage(ix, iy) = static_cast<byte_t>(sum / wsize);
+        }
+
+    return outputImage;
+}
+
+inline IntegralImage ReferenceIntegralImage(const Image& inputImage)
+{
+    IntegralImage integralImage(inputImage.Width(), inputImage.Height());
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+        {
+            lbyte_t sum = 0;
+
+            for (size_t sy = 0; sy <= iy; ++sy)
+                for (size_t sx = 0; sx <= ix; ++sx)
+                    sum += inputImage(sx, sy);
+
+            integralImage(ix, iy) = sum;
+        }
+
+    return integralImage;
+}
+
+// +-------------------------------------------< GAUSSIAN BLUR >--------------------------------------------+
+
+// The three box widths of GaussianBlur, whose cascade has the variance of the Gaussian
+inline void ReferenceGaussianBoxWidths(float sigma, int boxWidths[3])
+{
+    const double variance    = 12.0 * sigma * sigma;
+    int          narrowWidth = static_cast<int>(std::sqrt(variance / 3 + 1.0));
+
+    if (narrowWidth % 2 == 0)
+        --narrowWidth;
+
+    const long passes = std::min(std::max(std::lround((3 * (narrowWidth * narrowWidth + 4.0 * narrowWidth + 3.0) - variance) / (4.0 * narrowWidth + 4.0)), 0L), 3L);
+
+    for (int pass = 0; pass < 3; ++pass)
+        boxWidths[pass] = (pass < passes) ? (narrowWidth) : (narrowWidth + 2);
+}
+
+// Three box passes along the rows and three down the columns in double precision, each pass padding its own input by the border
+// mode, rounded once at the end. NONE blurs as REPLICATE and keeps the input on the frame of the combined radius.
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceGaussianBlur(const ImageBuffer<Pixel>& inputImage, float sigma, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    const int width  = static_cast<int>(inputImage.Width());
+    const int height = static_cast<int>(inputImage.Height());
+    int       boxWidths[3];
+
+    ReferenceGaussianBoxWidths(sigma, boxWidths);
+
+    const int          radius = boxWidths[0] / 2 + boxWidths[1] / 2 + boxWidths[2] / 2;
+    ImageBuffer<Pixel> outputImage(inputImage);
+
+    if (inputImage.IsEmpty() || (border == BorderMode::NONE && (2 * radius + 1 > width || 2 * radius + 1 > height)))
+        return outputImage;
+
+    const BorderMode passBorder = (border == BorderMode::NONE) ? (BorderMode::REPLICATE) : (border);
+
+    // One box pass over a line of samples
+    const auto boxPass = [&](std::vector<double>& line, int boxRadius) {
+        const int           length = static_cast<int>(line.size());
+        std::vector<double> filtered(length);
+
+        for (int index = 0; index < length; ++index)
+        {
+            double sum = 0.0;
+
+            for (int offset = -boxRadius; offset <= boxRadius; ++offset)
+            {
+                const ptrdiff_t source = BorderIndex(index + offset, length, passBorder);
+
+                sum += (source < 0) ? (static_cast<double>(borderValue)) : (line[source]);
+            }
+
+            filtered[index] = sum / (2 * boxRadius + 1);
+        }
+
+        line.swap(filtered);
+    };
+
+    std::vector<double> samples(static_cast<size_t>(width) * height * CHANNELS);
+
+    for (int iy = 0; iy < height; ++iy)
+        for (size_t channel = 0; channel < CHANNELS; ++channel)
+        {
+            std::vector<double> line(width);
+
+            for (int ix = 0; ix < width; ++ix)
+                line[ix] = SampleRow(inputImage, iy)[ix * CHANNELS + channel];
+            for (int pass = 0; pass < 3; ++pass)
+                boxPass(line, boxWidths[pass] / 2);
+            for (int ix = 0; ix < width; ++ix)
+                samples[(static_cast<size_t>(iy) * width + ix) * CHANNELS + channel] = line[ix];
+        }
+
+    for (int ix = 0; ix < width; ++ix)
+        for (size_t channel = 0; channel < CHANNELS; ++channel)
+        {
+            std::vector<double> line(height);
+
+            for (int iy = 0; iy < height; ++iy)
+                line[iy] = samples[(static_cast<size_t>(iy) * width + ix) * CHANNELS + channel];
+            for (int pass = 0; pass < 3; ++pass)
+                boxPass(line, boxWidths[pass] / 2);
+            for (int iy = 0; iy < height; ++iy)
+                if (border != BorderMode::NONE || !IsFramePixel(ix, iy, width, height, radius))
+                    SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>(line[iy] + 0.5);
+        }
+
+    return outputImage;
+}
+
+// +------------------------------------------< UNSHARP MASKING >-------------------------------------------+
+
+// inputImage + lambda * (inputImage - blurImage), clamped to the sample range and truncated
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceUnsharpMasking(const ImageBuffer<Pixel>& inputImage, const ImageBuffer<Pixel>& blurImage, float lambda)
+{
+    ImageBuffer<Pixel> outputImage(inputImage.Width(), inputImage.Height());
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t index = 0; index < inputImage.Width() * PixelTraits<Pixel>::CHANNELS; ++index)
+        {
+            const float input     = SampleRow(inputImage, iy)[index];
+            const float sharpened = input + lambda * (input - SampleRow(blurImage, iy)[index]);
+
+            SampleRow(outputImage, iy)[index] = static_cast<PixelSample<Pixel>>(std::min(std::max(sharpened, 0.0F), static_cast<float>(MaxSample<Pixel>())));
+        }
+
+    return outputImage;
+}
+
+// +--------------------------------------------< MEDIAN BLUR >---------------------------------------------+
+
+template <typename Sample>
+Sample ReferenceMedian(std::vector<Sample> samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2];
+}
+
+// The median of the whole window; NONE keeps the input where the window does not fit
+inline Image ReferenceMedianBlur(const Image& inputImage, int wsize, BorderMode border, byte_t borderValue)
+{
+    const int radius = wsize / 2;
+    Image     outputImage(inputImage);
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+        {
+            if (border == BorderMode::NONE && IsFramePixel(ix, iy, inputImage.Width(), inputImage.Height(), radius))
+                continue;
+
+            std::vector<byte_t> window;
+
+            for (int dy = -radius; dy <= radius; ++dy)
+                for (int dx = -radius; dx <= radius; ++dx)
+                    window.push_back(ReferenceSample(inputImage, ix + dx, iy + dy, 0, border, borderValue));
+
+            outputImage(ix, iy) = ReferenceMedian(window);
+        }
+
+    return outputImage;
+}
+
+// The column median of row medians. Under NONE the row medians cover the columns the window fits in and the input stands in for
+// the others, the column medians then cover every column of the rows the window fits in, and the other rows keep the input.
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceSeparableMedianBlur(const ImageBuffer<Pixel>& inputImage, int wsize, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    typedef PixelSample<Pixel> Sample;
+
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    const int          width  = static_cast<int>(inputImage.Width());
+    const int          height = static_cast<int>(inputImage.Height());
+    const int          radius = wsize / 2;
+    ImageBuffer<Pixel> outputImage(inputImage);
+
+    if (border == BorderMode::NONE && (wsize > width || wsize > height))
+        return outputImage;
+
+    const auto rowMedian = [&](int ix, int iy, size_t channel) {
+        if (border == BorderMode::NONE && (ix < radius || ix >= width - radius))
+            return SampleRow(inputImage, iy)[ix * CHANNELS + channel];
+
+        std::vector<Sample> window;
+
+        for (int dx = -radius; dx <= radius; ++dx)
+            window.push_back(ReferenceSample(inputImage, ix + dx, iy, channel, border, borderValue));
+
+        return ReferenceMedian(window);
+    };
+
+    for (int iy = 0; iy < height; ++iy)
+        for (int ix = 0; ix < width; ++ix)
+        {
+            if (border == BorderMode::NONE && (iy < radius || iy >= height - radius))
+                continue;
+
+            for (size_t channel = 0; channel < CHANNELS; ++channel)
+            {
+                std::vector<Sample> window;
+
+                for (int dy = -radius; dy <= radius; ++dy)
+                    window.push_back(rowMedian(ix, iy + dy, channel));
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = ReferenceMedian(window);
+            }
+        }
+
+    return outputImage;
+}
+
+// Only the impulses, samples at 0 or at the largest value, are filtered: the window grows from 3 x 3 until its median lies strictly
+// between its extremes or it reaches maxWsize, or under NONE the image border, and the median of the last window is taken
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceAdaptiveMedianBlur(const ImageBuffer<Pixel>& inputImage, int maxWsize, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    typedef PixelSample<Pixel> Sample;
+
+    static const int CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    const int          width  = static_cast<int>(inputImage.Width());
+    const int          height = static_cast<int>(inputImage.Height());
+    ImageBuffer<Pixel> outputImage(inputImage);
+
+    for (int iy = 0; iy < height; ++iy)
+        for (int ix = 0; ix < width; ++ix)
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const Sample input = SampleRow(inputImage, iy)[ix * CHANNELS + channel];
+
+                if (input != 0 && input != MaxSample<Pixel>())
+                    continue;
+
+                const int radiusLimit = (border == BorderMode::NONE) ? (std::min({ maxWsize / 2, ix, iy, width - 1 - ix, height - 1 - iy })) : (maxWsize / 2);
+                Sample    median      = input;
+
+                for (int radius = 1; radius <= radiusLimit; ++radius)
+                {
+                    std::vector<Sample> window;
+
+                    for (int dy = -radius; dy <= radius; ++dy)
+                        for (int dx = -radius; dx <= radius; ++dx)
+                            window.push_back(ReferenceSample(inputImage, ix + dx, iy + dy, channel, border, borderValue));
+
+                    std::sort(window.begin(), window.end());
+                    median = window[window.size() / 2];
+
+                    if (window.front() < median && median < window.back())
+                        break;
+                }
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = median;
+            }
+
+    return outputImage;
+}
+
+// +---------------------------------------------< HISTOGRAM >----------------------------------------------+
+
+// Every channel mapped through 2^bits - 1 times its own cumulative distribution, samples above 2^bits - 1 counting as 2^bits - 1
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceHistogramEqualization(const ImageBuffer<Pixel>& inputImage, int bits)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    const size_t       bins     = static_cast<size_t>(1) << bits;
+    const double       pixels   = static_cast<double>(inputImage.Width() * inputImage.Height());
+    ImageBuffer<Pixel> outputImage(inputImage);
+
+    const auto bin = [&](size_t iy, size_t index) {
+        return std::min<size_t>(SampleRow(inputImage, iy)[index], bins - 1);
+    };
+
+    for (size_t channel = 0; channel < CHANNELS; ++channel)
+    {
+        std::vector<uint64_t> counts(bins, 0);
+
+        for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+            for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+                counts[bin(iy, ix * CHANNELS + channel)]++;
+
+        for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+            for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+            {
+                double cdf = 0.0;
+
+                for (size_t below = 0; below <= bin(iy, ix * CHANNELS + channel); ++below)
+                    cdf = counts[below] / pixels + cdf;
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>((bins - 1) * cdf + 0.5);
+            }
+    }
+
+    return outputImage;
+}
+
+// Every brightness goes to the first brightness whose desired CDF reaches its own CDF, or stays when none does
+inline Image ReferenceHistogramSpecification(const Image& inputImage, BOI boi)
+{
+    float counts[256] = {};
+    float desiredCDF[256];
+    Image outputImage(inputImage);
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+            counts[inputImage(ix, iy)]++;
+
+    CreateDesiredCDF(desiredCDF, boi);
+
+    for (size_t iy = 0; iy < inputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < inputImage.Width(); ++ix)
+        {
+            float cdf = 0.0F;
+
+            for (int below = 0; below <= inputImage(ix, iy); ++below)
+                cdf = counts[below] / static_cast<float>(inputImage.Width() * inputImage.Height()) + cdf;
+
+            for (int brightness = 0; brightness < 256; ++brightness)
+                if (desiredCDF[brightness] >= cdf)
+                {
+                    outputImage(ix, iy) = static_cast<byte_t>(brightness);
+                    break;
+                }
+        }
+
+    return outputImage;
+}
+
+// Every tile equalized with its own histogram, clipped at clipLimit times the mean bin count with the excess spread over all bins,
+// and every pixel blending the four nearest tile mappings bilinearly by its distance to the tile centres
+inline Image ReferenceContrastLimitedEqualization(const Image& inputImage, int tilesX, int tilesY, float clipLimit)
+{
+    const size_t width  = inputImage.Width();
+    const size_t height = inputImage.Height();
+    Image        outputImage(inputImage);
+
+    tilesX = static_cast<int>(std::min<size_t>(tilesX, width));
+    tilesY = static_cast<int>(std::min<size_t>(tilesY, height));
+
+    std::vector<std::vector<double>> tileLUTs(static_cast<size_t>(tilesX) * tilesY, std::vector<double>(256));
+
+    for (int ty = 0; ty < tilesY; ++ty)
+        for (int tx = 0; tx < tilesX; ++tx)
+        {
+            std::vector<uint64_t> counts(256, 0);
+            uint64_t              pixels = 0;
+
+            for (size_t iy = ty * height / tilesY; iy < (ty + 1) * height / tilesY; ++iy)
+                for (size_t ix = tx * width / tilesX; ix < (tx + 1) * width / tilesX; ++ix, ++pixels)
+                    counts[inputImage(ix, iy)]++;
+
+            if (clipLimit > 0.0F)
+            {
+                const uint64_t limit  = std::max<uint64_t>(1, static_cast<uint64_t>(clipLimit * pixels / 256));
+                uint64_t       excess = 0;
+
+                for (uint64_t& count : counts)
+                    if (count > limit)
+                    {
+                        excess += count - limit;
+                        count   = limit;
+                    }
+
+                for (uint64_t& count : counts)
+                    count += excess / 256;
+                for (uint64_t index = 0; index < excess % 256; ++index)
+                    counts[index * 256 / (excess % 256)]++;
+            }
+
+            double cdf = 0.0;
+
+            for (int brightness = 0; brightness < 256; ++brightness)
+            {
+                cdf                                     = static_cast<double>(counts[brightness]) / pixels + cdf;
+                tileLUTs[ty * tilesX + tx][brightness] = static_cast<byte_t>(255 * cdf + 0.5);
+            }
+        }
+
+    // The tile whose centre lies at or before position, and the weight of the next one
+    const auto blend = [](size_t position, size_t length, int tiles, int& tile, double& weight) {
+        tile   = 0;
+        weight = 0.0;
+
+        while (tile + 1 < tiles && position >= ((tile + 1) * length / tiles + (tile + 2) * length / tiles - 1) / 2.0)
+            ++tile;
+
+        const double centre     = (tile * length / tiles + (tile + 1) * length / tiles - 1) / 2.0;
+        const double nextCentre = ((tile + 1) * length / tiles + (tile + 2) * length / tiles - 1) / 2.0;
+
+        if (tile + 1 < tiles && position > centre)
+            weight = (position - centre) / (nextCentre - centre);
+    };
+
+    for (size_t iy = 0; iy < height; ++iy)
+        for (size_t ix = 0; ix < width; ++ix)
+        {
+            int    tx, ty;
+            double wx, wy;
+
+            blend(ix, width, tilesX, tx, wx);
+            blend(iy, height, tilesY, ty, wy);
+
+            const int    right  = std::min(tx + 1, tilesX - 1);
+            const int    bottom = std::min(ty + 1, tilesY - 1);
+            const byte_t input  = inputImage(ix, iy);
+            const double top    = (1 - wx) * tileLUTs[ty * tilesX + tx][input] + wx * tileLUTs[ty * tilesX + right][input];
+            const double lower  = (1 - wx) * tileLUTs[bottom * tilesX + tx][input] + wx * tileLUTs[bottom * tilesX + right][input];
+
+            outputImage(ix, iy) = static_cast<byte_t>((1 - wy) * top + wy * lower + 0.5);
+        }
+
+    return outputImage;
+}
+
+// +--------------------------------------------< INTERPOLATOR >--------------------------------------------+
+
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceZeroOrderInterpolator(const ImageBuffer<Pixel>& inputImage, int magnification)
+{
+    ImageBuffer<Pixel> outputImage(inputImage.Width() * magnification, inputImage.Height() * magnification);
+
+    for (size_t iy = 0; iy < outputImage.Height(); ++iy)
+        for (size_t ix = 0; ix < outputImage.Width(); ++ix)
+            outputImage(ix, iy) = inputImage(ix / magnification, iy / magnification);
+
+    return outputImage;
+}
+
+// Pixels at even positions copy the input. On even rows an odd column is the rounded mean of its left and right neighbours, on odd
+// rows an even column that of its upper and lower ones, and the other pixels, the last row and the last column replicate.
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceFirstOrderInterpolator(const ImageBuffer<Pixel>& inputImage)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    const size_t       width  = inputImage.Width();
+    const size_t       height = inputImage.Height();
+    ImageBuffer<Pixel> outputImage(2 * width, 2 * height);
+
+    for (size_t iy = 0; iy < 2 * height; ++iy)
+        for (size_t ix = 0; ix < 2 * width; ++ix)
+            for (size_t channel = 0; channel < CHANNELS; ++channel)
+            {
+                const auto input = [&](size_t column, size_t row) {
+                    return static_cast<uint32_t>(SampleRow(inputImage, row)[column * CHANNELS + channel]);
+                };
+
+                uint32_t sample = input(ix / 2, iy / 2);
+
+                if (iy % 2 == 0 && ix % 2 == 1 && ix + 1 < 2 * width)
+                    sample = (input(ix / 2, iy / 2) + input(ix / 2 + 1, iy / 2) + 1) / 2;
+                else if (iy % 2 == 1 && ix % 2 == 0 && iy + 1 < 2 * height)
+                    sample = (input(ix / 2, iy / 2) + input(ix / 2, iy / 2 + 1) + 1) / 2;
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>(sample);
+            }
+
+    return outputImage;
+}
+
+// +---------------------------------------------< RESAMPLER >----------------------------------------------+
+
+inline double ReferenceFilterWeight(ResamplingFilter filter, double x)
+{
+    static const double PI = 3.14159265358979323846;
+
+    const auto sinc = [](double value) {
+        return (value == 0.0) ? (1.0) : (std::sin(PI * value) / (PI * value));
+    };
+
+    x = std::fabs(x);
+
+    switch (filter)
+    {
+    case ResamplingFilter::BILINEAR:
+        return std::max(0.0, 1.0 - x);
+    case ResamplingFilter::BICUBIC:
+        return (x < 1.0) ? (1.5 * x * x * x - 2.5 * x * x + 1.0) : ((x < 2.0) ? (-0.5 * x * x * x + 2.5 * x * x - 4.0 * x + 2.0) : (0.0));
+    default:
+        return (x < 3.0) ? (sinc(x) * sinc(x / 3.0)) : (0.0);
+    }
+}
+
+// The normalized weight of every input position for one output position, the filter widened by the scale when shrinking and the
+// positions outside the image folded onto the border pixel
+inline std::vector<double> ReferenceResamplingWeights(ResamplingFilter filter, size_t inputLength, size_t outputLength, size_t position)
+{
+    const double        scale       = static_cast<double>(inputLength) / outputLength;
+    const double        centre      = (position + 0.5) * scale;
+    std::vector<double> weights(inputLength, 0.0);
+
+    if (filter == ResamplingFilter::NEAREST)
+    {
+        weights[std::min<size_t>(static_cast<size_t>(centre), inputLength - 1)] = 1.0;
+
+        return weights;
+    }
+
+    const double filterScale = std::max(scale, 1.0);
+    const double support     = ((filter == ResamplingFilter::BILINEAR) ? (1.0) : ((filter == ResamplingFilter::BICUBIC) ? (2.0) : (3.0))) * filterScale;
+    double       weightSum   = 0.0;
+
+    for (long index = static_cast<long>(std::floor(centre - support)); index <= static_cast<long>(std::ceil(centre + support)); ++index)
+    {
+        const double weight = ReferenceFilterWeight(filter, (index + 0.5 - centre) / filterScale);
+
+        weights[std::min<long>(std::max<long>(index, 0), inputLength - 1)] += weight;
+        weightSum                                                          += weight;
+    }
+
+    for (double& weight : weights)
+        weight /= weightSum;
+
+    return weights;
+}
+
+// Separable filtering in double precision, clamped to the sample range and rounded
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceResample(const ImageBuffer<Pixel>& inputImage, size_t outputWidth, size_t outputHeight, ResamplingFilter filter)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    ImageBuffer<Pixel>               outputImage(outputWidth, outputHeight);
+    std::vector<std::vector<double>> columnWeights(outputWidth);
+
+    for (size_t ix = 0; ix < outputWidth; ++ix)
+        columnWeights[ix] = ReferenceResamplingWeights(filter, inputImage.Width(), outputWidth, ix);
+
+    for (size_t iy = 0; iy < outputHeight; ++iy)
+    {
+        const std::vector<double> rowWeights = ReferenceResamplingWeights(filter, inputImage.Height(), outputHeight, iy);
+
+        for (size_t ix = 0; ix < outputWidth; ++ix)
+            for (size_t channel = 0; channel < CHANNELS; ++channel)
+            {
+                double sum = 0.0;
+
+                for (size_t sy = 0; sy < inputImage.Height(); ++sy)
+                    if (rowWeights[sy] != 0.0)
+                        for (size_t sx = 0; sx < inputImage.Width(); ++sx)
+                            if (columnWeights[ix][sx] != 0.0)
+                                sum += rowWeights[sy] * columnWeights[ix][sx] * SampleRow(inputImage, sy)[sx * CHANNELS + channel];
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>(std::min(std::max(sum, 0.0), static_cast<double>(MaxSample<Pixel>())) + 0.5);
+            }
+    }
+
+    return outputImage;
+}
+
+// +--------------------------------------------< CONVOLUTION >---------------------------------------------+
+
+// The weighted window sum plus the offset in double precision, clamped to the sample range and rounded. NONE keeps the input on a
+// frame of Width() / 2 columns and Height() / 2 rows.
+template <typename Pixel>
+ImageBuffer<Pixel> ReferenceConvolve(const ImageBuffer<Pixel>& inputImage, const ConvolutionKernel& kernel, BorderMode border, PixelSample<Pixel> borderValue)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    ImageBuffer<Pixel> outputImage(inputImage);
+    const ptrdiff_t    radiusX = kernel.Width() / 2;
+    const ptrdiff_t    radiusY = kernel.Height() / 2;
+    const ptrdiff_t    width   = inputImage.Width();
+    const ptrdiff_t    height  = inputImage.Height();
+
+    for (ptrdiff_t iy = 0; iy < height; ++iy)
+        for (ptrdiff_t ix = 0; ix < width; ++ix)
+        {
+            if (border == BorderMode::NONE && (ix < radiusX || ix >= width - radiusX || iy < radiusY || iy >= height - radiusY))
+                continue;
+
+            for (size_t channel = 0; channel < CHANNELS; ++channel)
+            {
+                double sum = kernel.Offset();
+
+                for (ptrdiff_t dy = -radiusY; dy <= radiusY; ++dy)
+                    for (ptrdiff_t dx = -radiusX; dx <= radiusX; ++dx)
+                        sum += static_cast<double>(kernel.Weight(dx + radiusX, dy + radiusY)) * ReferenceSample(inputImage, ix + dx, iy + dy, channel, border, borderValue);
+
+                SampleRow(outputImage, iy)[ix * CHANNELS + channel] = static_cast<PixelSample<Pixel>>(std::min(std::max(sum, 0.0), static_cast<double>(MaxSample<Pixel>())) + 0.5);
+            }
+        }
+
+    return outputImage;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
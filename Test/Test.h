@@ -0,0 +1,162 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef TEST_H
+#define TEST_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+
+#include "Image.h"
+
+// +-----------------------------------------------< CHECK >------------------------------------------------+
+
+struct CheckSummary
+{
+    size_t checks;
+    size_t failures;
+    int    maxError;
+};
+
+// Checks per operation, in name order, for the summary every test prints at the end
+inline std::map<std::string, CheckSummary>& GetCheckSummaries()
+{
+    static std::map<std::string, CheckSummary> summaries;
+
+    return summaries;
+}
+
+// Compares actualImage with expectedImage sample by sample. A sample more than tolerance off fails the check: the largest error,
+// the number of mismatching pixels and the first of them are printed along with detail, which should say how to reproduce the
+// case, and a mismatch map is written to <operation>_Mismatch.raw in the working directory, 8-bit and of the image size, 255 on
+// every mismatching pixel. Pixels where mask is 0 are left out.
+template <typename Pixel>
+bool CheckImage(const char* operation, const std::string& detail, const ImageBuffer<Pixel>& expectedImage, const ImageBuffer<Pixel>& actualImage,
+                int tolerance = 0, const Image* mask = NULL)
+{
+    static const size_t CHANNELS = PixelTraits<Pixel>::CHANNELS;
+
+    CheckSummary& summary = GetCheckSummaries()[operation];
+
+    summary.checks++;
+
+    if (expectedImage.Width() != actualImage.Width() || expectedImage.Height() != actualImage.Height())
+    {
+        summary.failures++;
+        printf("FAILED %s (%s): %zux%zu instead of %zux%zu\n", operation, detail.c_str(), actualImage.Width(), actualImage.Height(),
+               expectedImage.Width(), expectedImage.Height());
+
+        return false;
+    }
+
+    Image  mismatchImage(expectedImage.Width(), expectedImage.Height());
+    size_t mismatches = 0;
+    int    maxError   = 0;
+    size_t firstX = 0, firstY = 0;
+
+    for (size_t iy = 0; iy < expectedImage.Height(); ++iy)
+        for (size_t ix = 0; ix < expectedImage.Width(); ++ix)
+        {
+            int error = 0;
+
+            if (mask == NULL || (*mask)(ix, iy) != 0)
+                for (size_t channel = 0; channel < CHANNELS; ++channel)
+                    error = std::max(error, std::abs(static_cast<int>(SampleRow(expectedImage, iy)[ix * CHANNELS + channel]) -
+                                                     static_cast<int>(SampleRow(actualImage, iy)[ix * CHANNELS + channel])));
+
+            maxError              = std::max(maxError, error);
+            mismatchImage(ix, iy) = (error > tolerance) ? (255) : (0);
+
+            if (error > tolerance && mismatches++ == 0)
+            {
+                firstX = ix;
+                firstY = iy;
+            }
+        }
+
+    summary.maxError = std::max(summary.maxError, maxError);
+
+    if (mismatches == 0)
+        return true;
+
+    std::string mismatchFileName = std::string(operation) + "_Mismatch.raw";
+
+    std::replace_if(mismatchFileName.begin(), mismatchFileName.end(), [](char character) { return !isalnum(static_cast<unsigned char>(character)) && character != '_' && character != '.'; }, '_');
+    WriteRawImage(mismatchFileName.c_str(), mismatchImage);
+
+    summary.failures++;
+    printf("FAILED %s (%s): max error %d, %zu of %zu pixels off by more than %d, the first at (%zu, %zu); mismatch map %s\n", operation, detail.c_str(),
+           maxError, mismatches, expectedImage.Width() * expectedImage.Height(), tolerance, firstX, firstY, mismatchFileName.c_str());
+
+    return false;
+}
+
+inline bool Check(const char* operation, const std::string& detail, bool condition)
+{
+    CheckSummary& summary = GetCheckSummaries()[operation];
+
+    summary.checks++;
+
+    if (!condition)
+    {
+        summary.failures++;
+        printf("FAILED %s (%s)\n", operation, detail.c_str());
+    }
+
+    return condition;
+}
+
+// Prints one line per operation and returns the exit code of the test
+inline int PrintCheckSummary()
+{
+    size_t failures = 0;
+
+    for (const auto& entry : GetCheckSummaries())
+    {
+        printf("%-36s %6zu checks, %4zu failed, max error %d\n", entry.first.c_str(), entry.second.checks, entry.second.failures, entry.second.maxError);
+        failures += entry.second.failures;
+    }
+
+    return (failures == 0) ? (0) : (1);
+}
+
+// +--------------------------------------------< RANDOM IMAGE >--------------------------------------------+
+
+// Uniform noise over the whole sample range, so every rounding and clipping path is hit
+template <typename Pixel>
+ImageBuffer<Pixel> CreateRandomImage(size_t width, size_t height, std::mt19937& random)
+{
+    ImageBuffer<Pixel> image(width, height);
+
+    std::uniform_int_distribution<int> distribution(0, static_cast<int>(MaxSample<Pixel>()));
+
+    for (size_t iy = 0; iy < height; ++iy)
+        for (size_t index = 0; index < width * PixelTraits<Pixel>::CHANNELS; ++index)
+            SampleRow(image, iy)[index] = static_cast<PixelSample<Pixel>>(distribution(random));
+
+    return image;
+}
+
+// A smooth gradient with a little noise, like a photograph, for the histogram operations that noise alone would flatten
+inline Image CreateNaturalImage(size_t width, size_t height, std::mt19937& random)
+{
+    Image image(width, height);
+
+    std::uniform_int_distribution<int> distribution(0, 24);
+
+    for (size_t iy = 0; iy < height; ++iy)
+        for (size_t ix = 0; ix < width; ++ix)
+            image(ix, iy) = static_cast<byte_t>(std::min<size_t>(255, (ix * 160 / std::max<size_t>(width, 1) + iy * 70 / std::max<size_t>(height, 1)) + distribution(random)));
+
+    return image;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,278 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef BATCH_OPERATION_H
+#define BATCH_OPERATION_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Batch Pipeline.h"
+#include "Command Line.h"
+#include "Convolution.h"
+#include "Histogram Equalization.h"
+#include "Histogram Sequence.h"
+#include "Histogram Specification.h"
+#include "Interpolator.h"
+#include "Median Blur.h"
+#include "Resampler.h"
+#include "Spatial Averaging.h"
+#include "Unsharp Masking.h"
+
+// +---------------------------------------------< OPERATION >----------------------------------------------+
+
+static const char* const OPERATIONS =
+    "operations, applied in the given order:\n"
+    "  average[:window size = 3]                  box averaging blur\n"
+    "  gaussian:<sigma>                           gaussian blur\n"
+    "  convolve:<kernel>                          sobel-x, sobel-y, laplacian or sharpen 3 x 3 convolution\n"
+    "  median[:window size = 3]                   histogram median blur\n"
+    "  adaptive-median[:max window size = 7]      adaptive median that only filters salt-and-pepper pixels\n"
+    "  salt-and-pepper:<ratio>[:seed = 0]         reproducible salt-and-pepper noise\n"
+    "  equalize                                   histogram equalization\n"
+    "  clahe[:tiles = 8[:clip limit = 2.0]]       contrast-limited adaptive equalization\n"
+    "  specify[:darkness | lightness]             histogram specification\n"
+    "  equalize-video[:smooth[:threshold]]        histogram equalization of the frames as one video\n"
+    "  specify-video[:boi[:smooth[:threshold]]]   histogram specification of the frames as one video\n"
+    "  unsharp[:window size = 5[:lambda = 0.3]]   unsharp masking\n"
+    "  unsharp:gaussian:<sigma>[:lambda = 0.3]    unsharp masking with a gaussian blur\n"
+    "  zero-order[:magnification = 2]             zero-order interpolation\n"
+    "  first-order                                first-order interpolation\n"
+    "  resample:<width>x<height>[:filter]         nearest, bilinear (default), bicubic or lanczos resampling\n"
+    "the derivative kernels sobel-x, sobel-y and laplacian are offset to mid-grey\n"
+    "the video operations blend smooth (0 ... 1) of the previous table into each frame's and keep a table while the CDF moves\n"
+    "less than threshold (0 ... 1)\n";
+
+// Splits "name:first:second" at the colons
+inline std::vector<std::string> SplitOperation(const char* text)
+{
+    std::vector<std::string> fields;
+    std::stringstream        stream(text);
+    std::string              field;
+
+    while (std::getline(stream, field, ':'))
+        fields.push_back(field);
+
+    return fields;
+}
+
+inline bool ParseOperation(const char* text, BatchOperation& operation)
+{
+    const std::vector<std::string> fields = SplitOperation(text);
+
+    if (fields.empty())
+        return false;
+
+    const std::string& name   = fields[0];
+    long               wsize  = (name == "unsharp") ? (5) : (3);
+    float              lambda = 0.3F;
+
+    if (name == "average" && fields.size() <= 2)
+    {
+        if (fields.size() == 2 && (!ParseInteger(fields[1].c_str(), 1, 4103, wsize) || wsize % 2 == 0))
+            return false;
+
+        operation = [wsize](const Image& inputImage, Image& outputImage) {
+            SlidingAveragingBlur(inputImage, outputImage, wsize, BorderMode::NONE);
+        };
+    }
+    else if (name == "gaussian" && fields.size() == 2)
+    {
+        float sigma;
+
+        if (!ParseFloat(fields[1].c_str(), sigma) || sigma < 0.0F)
+            return false;
+
+        operation = [sigma](const Image& inputImage, Image& outputImage) {
+            GaussianBlur(inputImage, outputImage, sigma);
+        };
+    }
+    else if (name == "convolve" && fields.size() == 2)
+    {
+        ConvolutionKernel kernel = ConvolutionKernel::Sharpening();
+
+        if (fields[1] == "sobel-x" || fields[1] == "sobel-y")
+            kernel = ConvolutionKernel::Sobel(fields[1] == "sobel-y", 128.0F);
+        else if (fields[1] == "laplacian")
+            kernel = ConvolutionKernel::Laplacian(128.0F);
+        else if (fields[1] != "sharpen")
+            return false;
+
+        operation = [kernel](const Image& inputImage, Image& outputImage) {
+            Convolve(inputImage, outputImage, kernel);
+        };
+    }
+    else if (name == "median" && fields.size() <= 2)
+    {
+        if (fields.size() == 2 && (!ParseInteger(fields[1].c_str(), 1, 255, wsize) || wsize % 2 == 0))
+            return false;
+
+        operation = [wsize](const Image& inputImage, Image& outputImage) {
+            HistogramMedianBlur(inputImage, outputImage, wsize);
+        };
+    }
+    else if (name == "adaptive-median" && fields.size() <= 2)
+    {
+        long maxWsize = 7;
+
+        if (fields.size() == 2 && (!ParseInteger(fields[1].c_str(), 3, 255, maxWsize) || maxWsize % 2 == 0))
+            return false;
+
+        operation = [maxWsize](const Image& inputImage, Image& outputImage) {
+            AdaptiveMedianBlur(inputImage, outputImage, maxWsize, BorderMode::REPLICATE);
+        };
+    }
+    else if (name == "salt-and-pepper" && (fields.size() == 2 || fields.size() == 3))
+    {
+        float ratio;
+        long  seed = 0;
+
+        if (!ParseFloat(fields[1].c_str(), ratio) || ratio < 0.0F || ratio > 1.0F)
+            return false;
+        if (fields.size() == 3 && !ParseInteger(fields[2].c_str(), 0, LONG_MAX, seed))
+            return false;
+
+        operation = [ratio, seed](const Image& inputImage, Image& outputImage) {
+            CreateSaltAndPepperNoise(inputImage, outputImage, ratio, seed);
+        };
+    }
+    else if (name == "equalize" && fields.size() == 1)
+    {
+        operation = [](const Image& inputImage, Image& outputImage) {
+            HistogramEqualization(inputImage, outputImage);
+        };
+    }
+    else if (name == "clahe" && fields.size() <= 3)
+    {
+        long  tiles     = 8;
+        float clipLimit = 2.0F;
+
+        if (fields.size() >= 2 && !ParseInteger(fields[1].c_str(), 1, 4096, tiles))
+            return false;
+        if (fields.size() == 3 && (!ParseFloat(fields[2].c_str(), clipLimit) || clipLimit < 0.0F))
+            return false;
+
+        operation = [tiles, clipLimit](const Image& inputImage, Image& outputImage) {
+            ContrastLimitedEqualization(inputImage, outputImage, tiles, tiles, clipLimit);
+        };
+    }
+    else if (name == "specify" && fields.size() <= 2)
+    {
+        BOI boi = BOI::DARKNESS;
+
+        if (fields.size() == 2 && fields[1] == "lightness")
+            boi = BOI::LIGHTNESS;
+        else if (fields.size() == 2 && fields[1] != "darkness")
+            return false;
+
+        operation = [boi](const Image& inputImage, Image& outputImage) {
+            HistogramSpecification(inputImage, outputImage, boi);
+        };
+    }
+    else if ((name == "equalize-video" && fields.size() <= 3) || (name == "specify-video" && fields.size() <= 4))
+    {
+        const size_t first     = (name == "specify-video") ? (2) : (1);
+        BOI          boi       = BOI::DARKNESS;
+        float        smoothing = 0.0F;
+        float        threshold = 0.0F;
+
+        if (first == 2 && fields.size() >= 2 && fields[1] == "lightness")
+            boi = BOI::LIGHTNESS;
+        else if (first == 2 && fields.size() >= 2 && fields[1] != "darkness")
+            return false;
+
+        if (fields.size() > first && (!ParseFloat(fields[first].c_str(), smoothing) || smoothing < 0.0F || smoothing >= 1.0F))
+            return false;
+        if (fields.size() > first + 1 && (!ParseFloat(fields[first + 1].c_str(), threshold) || threshold < 0.0F || threshold > 1.0F))
+            return false;
+
+        // The pipeline computes the frames in order on one thread, so the sequence state can live in the operation
+        const std::shared_ptr<HistogramSequence> sequence = std::make_shared<HistogramSequence>(
+            (first == 2) ? (HistogramSequence::Specification(boi, 255, smoothing, threshold)) : (HistogramSequence::Equalization(smoothing, threshold)));
+
+        operation = [sequence](const Image& inputImage, Image& outputImage) {
+            sequence->Process(inputImage, outputImage);
+        };
+    }
+    else if (name == "unsharp" && fields.size() >= 3 && fields.size() <= 4 && fields[1] == "gaussian")
+    {
+        float sigma;
+
+        if (!ParseFloat(fields[2].c_str(), sigma) || sigma < 0.0F)
+            return false;
+        if (fields.size() == 4 && (!ParseFloat(fields[3].c_str(), lambda) || lambda < 0.25F || lambda > 0.33F))
+            return false;
+
+        operation = [sigma, lambda](const Image& inputImage, Image& outputImage) {
+            GaussianUnsharpMasking(inputImage, outputImage, sigma, lambda);
+        };
+    }
+    else if (name == "unsharp" && fields.size() <= 3)
+    {
+        if (fields.size() >= 2 && (!ParseInteger(fields[1].c_str(), 1, 4103, wsize) || wsize % 2 == 0))
+            return false;
+        if (fields.size() == 3 && (!ParseFloat(fields[2].c_str(), lambda) || lambda < 0.25F || lambda > 0.33F))
+            return false;
+
+        operation = [wsize, lambda](const Image& inputImage, Image& outputImage) {
+            StreamingUnsharpMasking(inputImage, outputImage, wsize, lambda);
+        };
+    }
+    else if (name == "zero-order" && fields.size() <= 2)
+    {
+        long magnification = 2;
+
+        if (fields.size() == 2 && !ParseInteger(fields[1].c_str(), 1, 64, magnification))
+            return false;
+
+        operation = [magnification](const Image& inputImage, Image& outputImage) {
+            ZeroOrderInterpolator(inputImage, outputImage, magnification);
+        };
+    }
+    else if (name == "first-order" && fields.size() == 1)
+    {
+        operation = [](const Image& inputImage, Image& outputImage) {
+            FirstOrderInterpolator(inputImage, outputImage);
+        };
+    }
+    else if (name == "resample" && (fields.size() == 2 || fields.size() == 3))
+    {
+        static const char* FILTERS[] = { "nearest", "bilinear", "bicubic", "lanczos" };
+
+        const size_t     separator = fields[1].find('x');
+        long             outputWidth, outputHeight;
+        ResamplingFilter filter = ResamplingFilter::BILINEAR;
+
+        if (separator == std::string::npos || !ParseInteger(fields[1].substr(0, separator).c_str(), 1, 1L << 20, outputWidth) ||
+            !ParseInteger(fields[1].substr(separator + 1).c_str(), 1, 1L << 20, outputHeight))
+            return false;
+
+        if (fields.size() == 3)
+        {
+            const char** found = std::find(std::begin(FILTERS), std::end(FILTERS), fields[2]);
+
+            if (found == std::end(FILTERS))
+                return false;
+
+            filter = static_cast<ResamplingFilter>(found - std::begin(FILTERS));
+        }
+
+        operation = [outputWidth, outputHeight, filter](const Image& inputImage, Image& outputImage) {
+            Resample(inputImage, outputImage, outputWidth, outputHeight, filter);
+        };
+    }
+    else
+        return false;
+
+    return true;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,222 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+#endif
+
+#include "Batch Operation.h"
+#include "Batch Pipeline.h"
+#include "Command Line.h"
+#include "Instrumentation.h"
+
+// +---------------------------------------------< FRAME LIST >---------------------------------------------+
+
+static std::string BaseName(const std::string& fileName)
+{
+    const size_t separator = fileName.find_last_of("/\\");
+
+    return (separator == std::string::npos) ? (fileName) : (fileName.substr(separator + 1));
+}
+
+static bool EndsWithRaw(const std::string& fileName)
+{
+    return fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".raw") == 0;
+}
+
+#if defined(_WIN32)
+
+static bool IsDirectory(const char* path)
+{
+    const DWORD attributes = GetFileAttributesA(path);
+
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+}
+
+static bool ListDirectory(const std::string& directory, std::vector<std::string>& fileNames)
+{
+    WIN32_FIND_DATAA findData;
+    HANDLE           findHandle = FindFirstFileA((directory + "\\*").c_str(), &findData);
+
+    if (findHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            fileNames.push_back(findData.cFileName);
+    while (FindNextFileA(findHandle, &findData));
+    FindClose(findHandle);
+
+    return true;
+}
+
+#else
+
+static bool IsDirectory(const char* path)
+{
+    struct stat status;
+
+    return stat(path, &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+static bool ListDirectory(const std::string& directory, std::vector<std::string>& fileNames)
+{
+    DIR* directoryStream = opendir(directory.c_str());
+
+    if (directoryStream == NULL)
+        return false;
+
+    while (const dirent* entry = readdir(directoryStream))
+        fileNames.push_back(entry->d_name);
+    closedir(directoryStream);
+
+    return true;
+}
+
+#endif
+
+// Every *.raw file of the directory, in name order so runs are reproducible
+static bool ReadDirectoryFrames(const std::string& directory, size_t width, size_t height, const std::string& outputDirectory, std::vector<BatchFrame>& frames)
+{
+    std::vector<std::string> fileNames;
+
+    if (!ListDirectory(directory, fileNames))
+        return false;
+
+    std::sort(fileNames.begin(), fileNames.end());
+
+    for (const std::string& fileName : fileNames)
+        if (EndsWithRaw(fileName))
+            frames.push_back({ directory + "/" + fileName, outputDirectory + "/" + fileName, width, height });
+
+    return true;
+}
+
+// One frame per line as "<input.raw> [<width> <height>]", where the size defaults to the one given on the command line.
+// Blank lines and lines starting with # are skipped.
+static bool ReadManifestFrames(const char* manifest, size_t width, size_t height, const std::string& outputDirectory, std::vector<BatchFrame>& frames)
+{
+    std::ifstream manifestStream(manifest);
+    std::string   line;
+    size_t        lineNumber = 0;
+
+    if (!manifestStream)
+        return false;
+
+    while (std::getline(manifestStream, line))
+    {
+        std::istringstream lineStream(line);
+        std::string        fileName;
+        BatchFrame         frame = { "", "", width, height };
+
+        ++lineNumber;
+
+        if (!(lineStream >> fileName) || fileName[0] == '#')
+            continue;
+
+        if ((lineStream >> frame.width) && !(lineStream >> frame.height))
+        {
+            fprintf(stderr, "%s:%zu: expected <input.raw> [<width> <height>]\n", manifest, lineNumber);
+
+            return false;
+        }
+
+        frame.inputFileName  = fileName;
+        frame.outputFileName = outputDirectory + "/" + BaseName(fileName);
+        frames.push_back(frame);
+    }
+
+    return true;
+}
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "[--trace <trace.json>] <input directory | manifest> <width> <height> <output directory> <operation>...";
+
+    const char* traceFileName = NULL;
+
+    // The trace option comes first, the positional arguments then keep their indices
+    if (argc > 2 && strcmp(argv[1], "--trace") == 0)
+    {
+        traceFileName = argv[2];
+        argv[2]       = argv[0];
+        argv         += 2;
+        argc         -= 2;
+    }
+
+    std::vector<BatchOperation> operations(argc > 5 ? argc - 5 : 0);
+    std::vector<BatchFrame>     frames;
+    long                        width, height;
+
+    if (argc < 6 || !ParseInteger(argv[2], 1, 1L << 20, width) || !ParseInteger(argv[3], 1, 1L << 20, height))
+    {
+        PrintUsage(argv[0], ARGUMENTS);
+        fputs(OPERATIONS, stderr);
+
+        return 2;
+    }
+
+    for (int index = 5; index < argc; ++index)
+        if (!ParseOperation(argv[index], operations[index - 5]))
+        {
+            fprintf(stderr, "invalid operation %s\n", argv[index]);
+            fputs(OPERATIONS, stderr);
+
+            return 2;
+        }
+
+    const bool listed = (IsDirectory(argv[1])) ? (ReadDirectoryFrames(argv[1], width, height, argv[4], frames)) : (ReadManifestFrames(argv[1], width, height, argv[4], frames));
+
+    if (!listed)
+    {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+
+        return 1;
+    }
+
+    EnableInstrumentation(traceFileName != NULL);
+
+    const auto                start        = std::chrono::steady_clock::now();
+    const std::vector<size_t> failedFrames = RunBatchPipeline(frames, operations);
+    const double              seconds      = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t frameIndex : failedFrames)
+        fprintf(stderr, "cannot process %s\n", frames[frameIndex].inputFileName.c_str());
+
+    printf("%zu frames in %.3f s (%.1f frames/s), %zu failed\n", frames.size(), seconds, (seconds > 0.0) ? (frames.size() / seconds) : (0.0), failedFrames.size());
+
+    if (traceFileName != NULL)
+    {
+        PrintInstrumentationSummary(stderr);
+
+        if (!WriteChromeTrace(traceFileName))
+        {
+            fprintf(stderr, "cannot write %s\n", traceFileName);
+
+            return 1;
+        }
+    }
+
+    return (failedFrames.empty()) ? (0) : (1);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,80 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Image.h"
+
+// +-------------------------------------------< COMMAND LINE >---------------------------------------------+
+
+inline int PrintUsage(const char* program, const char* arguments)
+{
+    fprintf(stderr, "usage: %s %s\n", program, arguments);
+
+    return 2;
+}
+
+inline bool ParseInteger(const char* text, long minimum, long maximum, long& value)
+{
+    char* end;
+
+    errno = 0;
+    value = strtol(text, &end, 10);
+
+    return errno == 0 && end != text && *end == '\0' && value >= minimum && value <= maximum;
+}
+
+inline bool ParseFloat(const char* text, float& value)
+{
+    char* end;
+
+    errno = 0;
+    value = strtof(text, &end);
+
+    return errno == 0 && end != text && *end == '\0';
+}
+
+// Reads <input.raw> <width> <height> from argv[first] ... argv[first + 2]
+inline bool ReadInputImage(char** argv, int first, Image& inputImage)
+{
+    long width, height;
+
+    if (!ParseInteger(argv[first + 1], 1, 1L << 20, width) || !ParseInteger(argv[first + 2], 1, 1L << 20, height))
+    {
+        fprintf(stderr, "invalid image size %s x %s\n", argv[first + 1], argv[first + 2]);
+
+        return false;
+    }
+
+    if (!ReadRawImage(argv[first], inputImage, width, height))
+    {
+        fprintf(stderr, "cannot read %s\n", argv[first]);
+
+        return false;
+    }
+
+    return true;
+}
+
+inline bool WriteOutputImage(const std::string& fileName, const Image& outputImage)
+{
+    if (!WriteRawImage(fileName.c_str(), outputImage))
+    {
+        fprintf(stderr, "cannot write %s\n", fileName.c_str());
+
+        return false;
+    }
+
+    return true;
+}
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
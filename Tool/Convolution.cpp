@@ -0,0 +1,42 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Command Line.h"
+#include "Convolution.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output prefix> [sigma = 2.0]";
+
+    Image inputImage;
+    Image sobelXImage;
+    Image sobelYImage;
+    Image laplacianImage;
+    Image sharpeningImage;
+    Image gaussianImage;
+    float sigma = 2.0F;
+
+    if (argc < 5 || argc > 6 || (argc == 6 && (!ParseFloat(argv[5], sigma) || sigma < 0.0F)))
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    const std::string outputPrefix = argv[4];
+
+    // The derivatives are offset to mid-grey so their negative half stays visible
+    Convolve(inputImage, sobelXImage, ConvolutionKernel::Sobel(false, 128.0F));
+    Convolve(inputImage, sobelYImage, ConvolutionKernel::Sobel(true, 128.0F));
+    Convolve(inputImage, laplacianImage, ConvolutionKernel::Laplacian(128.0F));
+    Convolve(inputImage, sharpeningImage, ConvolutionKernel::Sharpening());
+    Convolve(inputImage, gaussianImage, ConvolutionKernel::Gaussian(sigma));
+
+    if (!WriteOutputImage(outputPrefix + "_SobelX.raw", sobelXImage) || !WriteOutputImage(outputPrefix + "_SobelY.raw", sobelYImage) ||
+        !WriteOutputImage(outputPrefix + "_Laplacian.raw", laplacianImage) || !WriteOutputImage(outputPrefix + "_Sharpening.raw", sharpeningImage) ||
+        !WriteOutputImage(outputPrefix + "_Gaussian.raw", gaussianImage))
+        return 1;
+
+    return 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,31 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Command Line.h"
+#include "Histogram Equalization.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output.raw> [adaptive tiles [clip limit = 2.0]]";
+
+    Image inputImage;
+    Image outputImage;
+    long  tiles     = 0;
+    float clipLimit = 2.0F;
+
+    if (argc < 5 || argc > 7 || (argc >= 6 && !ParseInteger(argv[5], 1, 4096, tiles)) || (argc == 7 && !ParseFloat(argv[6], clipLimit)) || clipLimit < 0.0F)
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    // A tile count switches from the global equalization to the contrast-limited one over tiles x tiles tiles
+    if (tiles > 0)
+        ContrastLimitedEqualization(inputImage, outputImage, tiles, tiles, clipLimit);
+    else
+        HistogramEqualization(inputImage, outputImage);
+
+    return WriteOutputImage(argv[4], outputImage) ? (0) : (1);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,35 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstring>
+
+#include "Command Line.h"
+#include "Histogram Specification.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output.raw> [darkness | lightness]";
+
+    Image inputImage;
+    Image outputImage;
+    BOI   boi = BOI::DARKNESS;
+
+    if (argc < 5 || argc > 6)
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (argc == 6)
+    {
+        if (strcmp(argv[5], "lightness") == 0)
+            boi = BOI::LIGHTNESS;
+        else if (strcmp(argv[5], "darkness") != 0)
+            return PrintUsage(argv[0], ARGUMENTS);
+    }
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    HistogramSpecification(inputImage, outputImage, boi);
+
+    return WriteOutputImage(argv[4], outputImage) ? (0) : (1);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,33 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Command Line.h"
+#include "Interpolator.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output prefix> [magnification = 2]";
+
+    Image inputImage;
+    Image zeroInterpolatorImage;
+    Image firstInterpolatorImage;
+    long  magnification = 2;
+
+    if (argc < 5 || argc > 6 || (argc == 6 && !ParseInteger(argv[5], 1, 64, magnification)))
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    const std::string outputPrefix = argv[4];
+
+    ZeroOrderInterpolator(inputImage, zeroInterpolatorImage, magnification);
+    FirstOrderInterpolator(inputImage, firstInterpolatorImage);
+
+    if (!WriteOutputImage(outputPrefix + "_ZeroInterpolator.raw", zeroInterpolatorImage) || !WriteOutputImage(outputPrefix + "_FirstInterpolator.raw", firstInterpolatorImage))
+        return 1;
+
+    return 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
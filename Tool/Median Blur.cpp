@@ -0,0 +1,46 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <climits>
+
+#include "Command Line.h"
+#include "Median Blur.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output prefix> [window size = 3] [noise ratio = 0.05] [seed = 0]";
+
+    Image inputImage;
+    Image outputImage;
+    long  wsize = 3;
+    float ratio = 0.05F;
+    long  seed  = 0;
+
+    if (argc < 5 || argc > 8 || (argc >= 6 && !ParseInteger(argv[5], 1, 65535, wsize)) || wsize % 2 == 0 ||
+        (argc >= 7 && !ParseFloat(argv[6], ratio)) || ratio < 0.0F || ratio > 1.0F || (argc == 8 && !ParseInteger(argv[7], 0, LONG_MAX, seed)))
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    const std::string outputPrefix = argv[4];
+
+    CreateSaltAndPepperNoise(inputImage, inputImage, ratio, seed);
+    SeparableHistogramMedianBlur(inputImage, outputImage, wsize);
+
+    if (!WriteOutputImage(outputPrefix + "_SaltAndPepper.raw", inputImage) || !WriteOutputImage(outputPrefix + "_SeparableMedian.raw", outputImage))
+        return 1;
+
+    // At 2 * min(width, height) - 1 the window spans the image in one direction, and a bound by the image keeps the window buffer small
+    const long maxWsize = std::min<long>(wsize, 2 * std::min(inputImage.Width(), inputImage.Height()) - 1);
+
+    AdaptiveMedianBlur(inputImage, outputImage, std::max(maxWsize, 3L), BorderMode::REPLICATE);
+
+    if (!WriteOutputImage(outputPrefix + "_AdaptiveMedian.raw", outputImage))
+        return 1;
+
+    return 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,49 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstring>
+
+#include "Command Line.h"
+#include "Resampler.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+static bool ParseResamplingFilter(const char* text, ResamplingFilter& filter)
+{
+    static const struct
+    {
+        const char*      name;
+        ResamplingFilter filter;
+    } FILTERS[] = { { "nearest", ResamplingFilter::NEAREST }, { "bilinear", ResamplingFilter::BILINEAR }, { "bicubic", ResamplingFilter::BICUBIC }, { "lanczos", ResamplingFilter::LANCZOS } };
+
+    for (const auto& entry : FILTERS)
+        if (strcmp(text, entry.name) == 0)
+        {
+            filter = entry.filter;
+
+            return true;
+        }
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output.raw> <output width> <output height> [nearest | bilinear | bicubic | lanczos]";
+
+    Image            inputImage;
+    Image            outputImage;
+    long             outputWidth, outputHeight;
+    ResamplingFilter filter = ResamplingFilter::BILINEAR;
+
+    if (argc < 7 || argc > 8 || !ParseInteger(argv[5], 1, 1L << 20, outputWidth) || !ParseInteger(argv[6], 1, 1L << 20, outputHeight) ||
+        (argc == 8 && !ParseResamplingFilter(argv[7], filter)))
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    Resample(inputImage, outputImage, outputWidth, outputHeight, filter);
+
+    return WriteOutputImage(argv[4], outputImage) ? (0) : (1);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
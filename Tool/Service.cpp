@@ -0,0 +1,443 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <csignal>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+#include "Batch Operation.h"
+#include "Command Line.h"
+#include "Image Service.h"
+
+// +-----------------------------------------------< CHAIN >------------------------------------------------+
+
+// Parses operations separated by spaces; an empty text is the empty chain, which returns the image as it is
+static std::shared_ptr<const OperationChain> ParseChain(const std::string& text)
+{
+    std::shared_ptr<OperationChain> chain = std::make_shared<OperationChain>();
+    std::istringstream              stream(text);
+    std::string                     operationText;
+
+    while (stream >> operationText)
+    {
+        chain->emplace_back();
+
+        if (!ParseOperation(operationText.c_str(), chain->back()))
+            return nullptr;
+    }
+
+    return chain;
+}
+
+// +------------------------------------------------< LOAD >------------------------------------------------+
+
+// Sends requestCount requests from clientCount threads, each waiting for the result of one request before it sends the next, and
+// prints the throughput and the latency percentiles. roundTrip runs one request of the given client.
+static int RunLoad(const Image& image, size_t requestCount, size_t clientCount, const std::function<bool(size_t client, const Image& inputImage, Image& outputImage)>& roundTrip)
+{
+    std::vector<double>      latencies(requestCount);
+    std::vector<std::thread> clients;
+    std::atomic<size_t>      nextRequest(0);
+    std::atomic<size_t>      failedRequests(0);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t client = 0; client < clientCount; ++client)
+        clients.emplace_back([&, client] {
+            Image outputImage;
+
+            for (size_t request = nextRequest++; request < requestCount; request = nextRequest++)
+            {
+                const auto sent = std::chrono::steady_clock::now();
+
+                if (!roundTrip(client, image, outputImage))
+                    failedRequests++;
+
+                latencies[request] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent).count();
+            }
+        });
+
+    for (std::thread& client : clients)
+        client.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    const auto percentile = [&](double fraction) {
+        return (latencies.empty()) ? (0.0) : (latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))]);
+    };
+
+    printf("%zu requests of %zux%zu in %.3f s (%.1f requests/s), latency p50 %.3f ms p99 %.3f ms max %.3f ms, %zu failed\n", requestCount,
+           image.Width(), image.Height(), seconds, (seconds > 0.0) ? (requestCount / seconds) : (0.0), percentile(0.5), percentile(0.99),
+           percentile(1.0), failedRequests.load());
+
+    return (failedRequests == 0) ? (0) : (1);
+}
+
+// The same gradient with some texture every time, so runs are reproducible
+static Image CreateLoadImage(size_t width, size_t height)
+{
+    Image image(width, height);
+
+    for (size_t iy = 0; iy < height; ++iy)
+        for (size_t ix = 0; ix < width; ++ix)
+            image(ix, iy) = static_cast<byte_t>((ix + iy) * 255 / (width + height) + (ix * 7 + iy * 13) % 17);
+
+    return image;
+}
+
+// Runs the load against a service in this process, without a socket in between. Every client has a chain of its own, as it would
+// on a connection of its own, so the video operations never see the frames of two clients at once.
+static int RunLocalLoad(const Image& image, size_t requestCount, size_t clientCount, const std::string& chainText)
+{
+    ImageService                                       service;
+    std::vector<std::shared_ptr<const OperationChain>> chains(clientCount);
+
+    for (std::shared_ptr<const OperationChain>& chain : chains)
+        chain = ParseChain(chainText);
+
+    const int status = RunLoad(image, requestCount, clientCount, [&](size_t client, const Image& inputImage, Image& outputImage) {
+        ServiceResult result = service.Submit(inputImage, chains[client]).get();
+
+        outputImage = std::move(result.image);
+
+        return !result.failed;
+    });
+
+    const ServiceStatistics statistics = service.GetStatistics();
+
+    printf("%zu batches, %.2f requests per batch\n", statistics.batches, (statistics.batches != 0) ? (static_cast<double>(statistics.completed) / statistics.batches) : (0.0));
+
+    return status;
+}
+
+// +-----------------------------------------------< SOCKET >-----------------------------------------------+
+
+#if !defined(_WIN32)
+
+// Every request is a RequestHeader, the operations as text separated by spaces and the pixels row by row; every response is a
+// ResponseHeader and the pixels of the result. Both ends share one host, so the numbers travel in its byte order.
+struct RequestHeader
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t chainLength;
+};
+
+enum class ResponseStatus : uint32_t
+{
+    SUCCEEDED       = 0,
+    INVALID_REQUEST = 1,
+    FAILED          = 2 // The chain could not run, such as for lack of memory
+};
+
+struct ResponseHeader
+{
+    ResponseStatus status;
+    uint32_t       width;
+    uint32_t       height;
+};
+
+static bool ReceiveAll(int socket, void* data, size_t bytes)
+{
+    for (char* position = static_cast<char*>(data); bytes > 0;)
+    {
+        const ssize_t received = recv(socket, position, bytes, 0);
+
+        if (received <= 0)
+            return false;
+
+        position += received;
+        bytes    -= received;
+    }
+
+    return true;
+}
+
+static bool SendAll(int socket, const void* data, size_t bytes)
+{
+    for (const char* position = static_cast<const char*>(data); bytes > 0;)
+    {
+        const ssize_t sent = send(socket, position, bytes, 0);
+
+        if (sent <= 0)
+            return false;
+
+        position += sent;
+        bytes    -= sent;
+    }
+
+    return true;
+}
+
+static bool ReceiveImage(int socket, Image& image, size_t width, size_t height)
+{
+    image.Resize(width, height);
+
+    for (size_t iy = 0; iy < height; ++iy)
+        if (!ReceiveAll(socket, image.Row(iy), width))
+            return false;
+
+    return true;
+}
+
+static bool SendImage(int socket, const Image& image)
+{
+    for (size_t iy = 0; iy < image.Height(); ++iy)
+        if (!SendAll(socket, image.Row(iy), image.Width()))
+            return false;
+
+    return true;
+}
+
+static bool CreateAddress(const char* socketPath, sockaddr_un& address)
+{
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "socket path too long: %s\n", socketPath);
+
+        return false;
+    }
+
+    strcpy(address.sun_path, socketPath);
+
+    return true;
+}
+
+static bool SendStatus(int socket, ResponseStatus status)
+{
+    const ResponseHeader response = { status, 0, 0 };
+
+    return SendAll(socket, &response, sizeof(response));
+}
+
+// Serves one connection, one request after the other. The chain is parsed again only when its text changes, so the video
+// operations of a client that keeps sending the same chain see its frames as one sequence. A header out of bounds gets
+// INVALID_REQUEST and ends the connection, since the rest of the request is left unread.
+static void ServeConnection(int connection, ImageService& service)
+{
+    static const uint64_t MAX_PIXELS       = 1ULL << 26; // 8192 x 8192
+    static const uint32_t MAX_CHAIN_LENGTH = 1U << 16;
+
+    std::string                           chainText;
+    std::shared_ptr<const OperationChain> chain;
+    RequestHeader                         header;
+    Image                                 image;
+
+    // Whatever throws, such as an allocation the server cannot afford, ends this connection and leaves the others serving
+    try
+    {
+        while (ReceiveAll(connection, &header, sizeof(header)))
+        {
+            if (header.width == 0 || header.height == 0 || static_cast<uint64_t>(header.width) * header.height > MAX_PIXELS ||
+                header.chainLength > MAX_CHAIN_LENGTH)
+            {
+                SendStatus(connection, ResponseStatus::INVALID_REQUEST);
+                break;
+            }
+
+            std::string text(header.chainLength, '\0');
+
+            if (!ReceiveAll(connection, &text[0], text.size()) || !ReceiveImage(connection, image, header.width, header.height))
+                break;
+
+            if (chain == nullptr || text != chainText)
+            {
+                chain     = ParseChain(text);
+                chainText = text;
+            }
+
+            if (chain == nullptr)
+            {
+                if (!SendStatus(connection, ResponseStatus::INVALID_REQUEST))
+                    break;
+
+                continue;
+            }
+
+            // The image goes to the service and comes back as the result, in the same buffer when it fits
+            ServiceResult result = service.Submit(std::move(image), chain).get();
+
+            image = std::move(result.image);
+
+            if (result.failed)
+            {
+                if (!SendStatus(connection, ResponseStatus::FAILED))
+                    break;
+
+                continue;
+            }
+
+            const ResponseHeader response = { ResponseStatus::SUCCEEDED, static_cast<uint32_t>(image.Width()), static_cast<uint32_t>(image.Height()) };
+
+            if (!SendAll(connection, &response, sizeof(response)) || !SendImage(connection, image))
+                break;
+        }
+    }
+    catch (const std::exception&)
+    {
+        SendStatus(connection, ResponseStatus::FAILED);
+    }
+
+    close(connection);
+}
+
+static int Serve(const char* socketPath, size_t workerCount)
+{
+    sockaddr_un address;
+    const int   listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0 || !CreateAddress(socketPath, address))
+        return 1;
+
+    unlink(socketPath);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0)
+    {
+        fprintf(stderr, "cannot listen on %s\n", socketPath);
+
+        return 1;
+    }
+
+    ServiceSettings settings;
+
+    settings.workerCount = workerCount;
+
+    ImageService service(settings);
+
+    printf("listening on %s\n", socketPath);
+    fflush(stdout);
+
+    for (;;)
+    {
+        const int connection = accept(listener, NULL, NULL);
+
+        if (connection >= 0)
+            std::thread(ServeConnection, connection, std::ref(service)).detach();
+    }
+}
+
+static int RunSocketLoad(const char* socketPath, const Image& image, size_t requestCount, size_t clientCount, const std::string& chainText)
+{
+    sockaddr_un      address;
+    std::vector<int> connections(clientCount, -1);
+
+    if (!CreateAddress(socketPath, address))
+        return 1;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int& connection : connections)
+    {
+        connection = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (connection < 0 || connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            fprintf(stderr, "cannot connect to %s\n", socketPath);
+
+            return 1;
+        }
+    }
+
+    const RequestHeader header = { static_cast<uint32_t>(image.Width()), static_cast<uint32_t>(image.Height()), static_cast<uint32_t>(chainText.size()) };
+
+    const int status = RunLoad(image, requestCount, clientCount, [&](size_t client, const Image& inputImage, Image& outputImage) {
+        ResponseHeader response;
+
+        return SendAll(connections[client], &header, sizeof(header)) && SendAll(connections[client], chainText.data(), chainText.size()) &&
+               SendImage(connections[client], inputImage) && ReceiveAll(connections[client], &response, sizeof(response)) &&
+               response.status == ResponseStatus::SUCCEEDED && ReceiveImage(connections[client], outputImage, response.width, response.height);
+    });
+
+    for (int connection : connections)
+        close(connection);
+
+    return status;
+}
+
+#endif
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "serve <socket> [<workers> = 0]\n"
+                                   "       load <socket> <width> <height> <requests> <clients> [<operation>...]\n"
+                                   "       local <width> <height> <requests> <clients> [<operation>...]";
+
+    const bool local = argc > 1 && strcmp(argv[1], "local") == 0;
+    const int  first = (local) ? (2) : (3);
+    long       width, height, requestCount, clientCount, workerCount = 0;
+
+    if (argc >= 3 && strcmp(argv[1], "serve") == 0 && argc <= 4 && (argc == 3 || ParseInteger(argv[3], 0, 4096, workerCount)))
+    {
+#if defined(_WIN32)
+        fputs("local sockets are not supported on this platform\n", stderr);
+
+        return 1;
+#else
+        return Serve(argv[2], workerCount);
+#endif
+    }
+
+    if ((!local && (argc < 7 || strcmp(argv[1], "load") != 0)) || (local && argc < 6) || !ParseInteger(argv[first], 1, 1L << 20, width) ||
+        !ParseInteger(argv[first + 1], 1, 1L << 20, height) || !ParseInteger(argv[first + 2], 1, LONG_MAX, requestCount) ||
+        !ParseInteger(argv[first + 3], 1, 4096, clientCount))
+    {
+        PrintUsage(argv[0], ARGUMENTS);
+        fputs(OPERATIONS, stderr);
+
+        return 2;
+    }
+
+    std::string chainText;
+
+    for (int index = first + 4; index < argc; ++index)
+        chainText += std::string((chainText.empty()) ? ("") : (" ")) + argv[index];
+
+    if (ParseChain(chainText) == nullptr)
+    {
+        fprintf(stderr, "invalid operations %s\n", chainText.c_str());
+        fputs(OPERATIONS, stderr);
+
+        return 2;
+    }
+
+    const Image image = CreateLoadImage(width, height);
+
+    if (local)
+        return RunLocalLoad(image, requestCount, clientCount, chainText);
+
+#if defined(_WIN32)
+    fputs("local sockets are not supported on this platform\n", stderr);
+
+    return 1;
+#else
+    return RunSocketLoad(argv[2], image, requestCount, clientCount, chainText);
+#endif
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
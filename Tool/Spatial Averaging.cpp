@@ -0,0 +1,47 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Command Line.h"
+#include "Spatial Averaging.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output prefix> [window size = 21] [sigma = window size / 6]";
+
+    Image         inputImage;
+    Image         spatialAveragingImage;
+    Image         separableSpatialAveragingImage;
+    IntegralImage integralImage;
+    Image         normalizationIntegralImage;
+    Image         integralSpatialAveragingImage;
+    Image         slidingSpatialAveragingImage;
+    Image         gaussianImage;
+    long          wsize = 21;
+    float         sigma = -1.0F;
+
+    if (argc < 5 || argc > 7 || (argc >= 6 && !ParseInteger(argv[5], 1, 4103, wsize)) || wsize % 2 == 0 ||
+        (argc == 7 && (!ParseFloat(argv[6], sigma) || sigma < 0.0F)))
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    const std::string outputPrefix = argv[4];
+
+    AveragingBlur(inputImage, spatialAveragingImage, wsize);
+    SeparableAveragingBlur(inputImage, separableSpatialAveragingImage, wsize);
+    CreateIntegralImage(inputImage, integralImage);
+    NormalizationIntegralImage(integralImage, normalizationIntegralImage);
+    IntegralAveragingBlur(inputImage, integralImage, integralSpatialAveragingImage, wsize);
+    SlidingAveragingBlur(inputImage, slidingSpatialAveragingImage, wsize);
+    GaussianBlur(inputImage, gaussianImage, (sigma < 0.0F) ? (wsize / 6.0F) : (sigma));
+
+    if (!WriteOutputImage(outputPrefix + "_Avg.raw", spatialAveragingImage) || !WriteOutputImage(outputPrefix + "_SeparableAvg.raw", separableSpatialAveragingImage) ||
+        !WriteOutputImage(outputPrefix + "_Integral.raw", normalizationIntegralImage) || !WriteOutputImage(outputPrefix + "_IntegralAvg.raw", integralSpatialAveragingImage) ||
+        !WriteOutputImage(outputPrefix + "_SlidingAvg.raw", slidingSpatialAveragingImage) || !WriteOutputImage(outputPrefix + "_Gaussian.raw", gaussianImage))
+        return 1;
+
+    return 0;
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
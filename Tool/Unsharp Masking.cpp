@@ -0,0 +1,36 @@
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include <cstring>
+
+#include "Command Line.h"
+#include "Unsharp Masking.h"
+
+// +------------------------------------------------< MAIN >------------------------------------------------+
+
+int main(int argc, char** argv)
+{
+    static const char* ARGUMENTS = "<input.raw> <width> <height> <output.raw> [window size = 5 | gaussian:<sigma>] [lambda = 0.3]";
+
+    Image inputImage;
+    Image outputImage;
+    long  wsize    = 5;
+    float sigma    = 0.0F;
+    float lambda   = 0.3F;
+    bool  gaussian = argc >= 6 && strncmp(argv[5], "gaussian:", 9) == 0;
+
+    if (argc < 5 || argc > 7 || (gaussian && (!ParseFloat(argv[5] + 9, sigma) || sigma < 0.0F)) ||
+        (!gaussian && argc >= 6 && !ParseInteger(argv[5], 1, 4103, wsize)) || wsize % 2 == 0 ||
+        (argc == 7 && !ParseFloat(argv[6], lambda)) || lambda < 0.25F || lambda > 0.33F)
+        return PrintUsage(argv[0], ARGUMENTS);
+    if (!ReadInputImage(argv, 1, inputImage))
+        return 1;
+
+    if (gaussian)
+        GaussianUnsharpMasking(inputImage, outputImage, sigma, lambda);
+    else
+        StreamingUnsharpMasking(inputImage, outputImage, wsize, lambda);
+
+    return WriteOutputImage(argv[4], outputImage) ? (0) : (1);
+}
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
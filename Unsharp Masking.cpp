@@ -6,131 +6,148 @@
 
 // +----------------------------------------------< INCLUDE >-----------------------------------------------+
 
-#include <Windows.h>
-
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
-#include <cstdio>
 #include <cstring>
+#include <limits>
+
+#include "Image Pool.h"
+#include "Instrumentation.h"
+#include "Integral Kernel.h"
+#include "Parallel Executor.h"
+#include "Spatial Averaging.h"
+#include "Unsharp Masking.h"
 
-// +------------------------------------------< TYPE DEFINITION >-------------------------------------------+
+// +------------------------------------------< UNSHARP MASKING >-------------------------------------------+
 
-typedef uint8_t  byte_t;
-typedef uint32_t lbyte_t;
+// Clamps to the sample range before truncating, since a negative brightness converted to an unsigned type is undefined
+template <typename Sample>
+static Sample ClipSample(float brightness)
+{
+    return static_cast<Sample>(std::min(std::max(brightness, 0.0F), static_cast<float>(std::numeric_limits<Sample>::max())));
+}
 
-// +------------------------------------------< GLOBAL VARIABLE >-------------------------------------------+
+template <typename Pixel>
+ImageBuffer<Pixel>& UnsharpMasking(const ImageBuffer<Pixel>& inputImage, const ImageBuffer<Pixel>& blurImage, ImageBuffer<Pixel>& outputImage, const float lambda)
+{
+    TraceScope trace("UnsharpMasking", inputImage, outputImage);
 
-static const size_t WIDTH  = 512;
-static const size_t HEIGHT = 512;
+    typedef PixelSample<Pixel> Sample;
 
-byte_t  inputImage[WIDTH * HEIGHT];
-lbyte_t integralImage[WIDTH * HEIGHT];
-byte_t  integralSpatialAveragingImage[WIDTH * HEIGHT];
-byte_t  outputImage[WIDTH * HEIGHT];
+    assert(blurImage.Width()  == inputImage.Width());
+    assert(blurImage.Height() == inputImage.Height());
+    assert(lambda >= 0.25F && lambda <= 0.33F);
 
-// +-------------------------------------------< AVERAGING BLUR >-------------------------------------------+
+    const size_t samples = inputImage.Width() * PixelTraits<Pixel>::CHANNELS;
+    const size_t height  = inputImage.Height();
 
-byte_t CalculateIntegralWindowAverage(lbyte_t* integralImage, POINT center, SIZE wsize)
-{
-    assert(center.x >= wsize.cx / 2 && center.x < WIDTH - wsize.cx / 2);
-    assert(center.y >= wsize.cy / 2 && center.y < HEIGHT - wsize.cy / 2);
-    assert(wsize.cx % 2 == 1);
-    assert(wsize.cy % 2 == 1);
+    outputImage.Resize(inputImage.Width(), height);
 
-    long integralSum = integralImage[(center.y + wsize.cy / 2) * WIDTH + (center.x + wsize.cx / 2)];
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        for (size_t iy = bandBegin; iy < bandEnd; ++iy)
+        {
+            const Sample* inputRow  = SampleRow(inputImage, iy);
+            const Sample* blurRow   = SampleRow(blurImage, iy);
+            Sample*       outputRow = SampleRow(outputImage, iy);
 
-    if (center.x > wsize.cx / 2)
-        integralSum -= integralImage[(center.y + wsize.cy / 2) * WIDTH + (center.x - wsize.cx / 2 - 1)];
-    if (center.y > wsize.cy / 2)
-        integralSum -= integralImage[(center.y - wsize.cy / 2 - 1) * WIDTH + (center.x + wsize.cx / 2)];
-    if (center.x > wsize.cx / 2 && center.y > wsize.cy / 2)
-        integralSum += integralImage[(center.y - wsize.cy / 2 - 1) * WIDTH + (center.x - wsize.cx / 2 - 1)];
+            for (size_t index = 0; index < samples; ++index)
+                outputRow[index] = ClipSample<Sample>(inputRow[index] + lambda * (inputRow[index] - blurRow[index]));
+        }
+    });
 
-    return static_cast<byte_t>(integralSum / (wsize.cx * wsize.cy) + 0.5);
+    return outputImage;
 }
 
-lbyte_t* CreateIntegralImage(byte_t* inputImage, lbyte_t* integralImage)
+template Image&     UnsharpMasking(const Image&, const Image&, Image&, const float);
+template WideImage& UnsharpMasking(const WideImage&, const WideImage&, WideImage&, const float);
+template RGBImage&  UnsharpMasking(const RGBImage&, const RGBImage&, RGBImage&, const float);
+template RGBAImage& UnsharpMasking(const RGBAImage&, const RGBAImage&, RGBAImage&, const float);
+
+Image& StreamingUnsharpMasking(const Image& inputImage, Image& outputImage, const int wsize, const float lambda)
 {
-    assert(inputImage    != NULL);
-    assert(integralImage != NULL);
+    TraceScope trace("StreamingUnsharpMasking", inputImage, outputImage);
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        integralImage[iy * WIDTH] = inputImage[iy * WIDTH];
+    assert(&inputImage != &outputImage);
+    assert(wsize % 2   == 1);
+    assert(wsize       <= 4103);
+    assert(lambda >= 0.25F && lambda <= 0.33F);
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        for (int ix = 1; ix < WIDTH; ++ix)
-            integralImage[iy * WIDTH + ix] = inputImage[iy * WIDTH + ix] + integralImage[iy * WIDTH + (ix - 1)];
+    const int  width   = static_cast<int>(inputImage.Width());
+    const int  height  = static_cast<int>(inputImage.Height());
+    const int  radius  = wsize / 2;
+    const bool blurred = wsize <= width && wsize <= height;
 
-    for (int ix = 0; ix < WIDTH; ++ix)
-        for (int iy = 1; iy < HEIGHT; ++iy)
-            integralImage[iy * WIDTH + ix] += integralImage[(iy - 1) * WIDTH + ix];
+    outputImage.Resize(width, height);
 
-    return integralImage;
-}
+    // Every band keeps a ring of the wsize + 1 integral rows its current window needs and rolls it down one row at a time, so
+    // neither the integral image nor the blurred image is ever materialized. The ring starts from a zero row just above the
+    // first window of the band: the rows above it add the same offset to the top and bottom integral rows, which cancels in
+    // every box sum. Pixels whose window leaves the image keep their own value as the blur, exactly like IntegralAveragingBlur.
+    ParallelForRows(0, height, [&](size_t bandBegin, size_t bandEnd) {
+        const int rowBegin = std::max(static_cast<int>(bandBegin), radius);
+        const int rowEnd   = (blurred) ? (std::min(static_cast<int>(bandEnd), height - radius)) : (rowBegin);
+        const int base     = rowBegin - radius - 1;
 
-byte_t* IntegralAveragingBlur(byte_t* inputImage, lbyte_t* integralImage, byte_t* outputImage, const int wsize)
-{
-    assert(inputImage    != NULL);
-    assert(integralImage != NULL);
-    assert(outputImage   != NULL);
+        ScratchImage<lbyte_t> integralRing;
+        ScratchBuffer<byte_t> blurRow(width);
 
-    memcpy(outputImage, inputImage, WIDTH * HEIGHT);
+        auto RingRow = [&](int iy) {
+            return integralRing.Row((iy - base) % (wsize + 1));
+        };
 
-    for (int iy = wsize / 2; iy < HEIGHT - wsize / 2; ++iy)
-        for (int ix = wsize / 2; ix < WIDTH - wsize / 2; ++ix)
-            outputImage[iy * WIDTH + ix] = CalculateIntegralWindowAverage(integralImage, { ix, iy }, { wsize, wsize });
+        if (rowBegin < rowEnd)
+        {
+            integralRing.Resize(width, wsize + 1);
+            memset(RingRow(base), 0, width * sizeof(lbyte_t));
 
-    return outputImage;
-}
+            for (int iy = base + 1; iy < rowBegin + radius; ++iy)
+                IntegralImageRow(inputImage.Row(iy), RingRow(iy - 1), RingRow(iy), width);
+        }
 
-// +------------------------------------------< UNSHARP MASKING >-------------------------------------------+
+        for (int iy = static_cast<int>(bandBegin); iy < static_cast<int>(bandEnd); ++iy)
+        {
+            const byte_t* inputRow  = inputImage.Row(iy);
+            byte_t*       outputRow = outputImage.Row(iy);
 
-byte_t Clipping(lbyte_t brightness)
-{
-    if (brightness > 255)
-        return static_cast<byte_t>(255);
-    else if (brightness < 0)
-        return static_cast<byte_t>(0);
+            memcpy(blurRow.Data(), inputRow, width);
 
-    return static_cast<byte_t>(brightness);
-}
+            if (iy >= rowBegin && iy < rowEnd)
+            {
+                IntegralImageRow(inputImage.Row(iy + radius), RingRow(iy + radius - 1), RingRow(iy + radius), width);
 
-byte_t* UnsharpMasking(byte_t* inputImage, byte_t* blurImage, byte_t* outputImage, const float lambda = 0.3F)
-{
-    assert(inputImage  != NULL);
-    assert(blurImage   != NULL);
-    assert(outputImage != NULL);
-    assert(lambda >= 0.25F && lambda <= 0.33F);
+                const lbyte_t* topRow    = RingRow(iy - radius - 1);
+                const lbyte_t* bottomRow = RingRow(iy + radius);
+
+                blurRow[radius] = static_cast<byte_t>((bottomRow[wsize - 1] - topRow[wsize - 1]) / (wsize * wsize));
+                IntegralBoxAverageRow(topRow, bottomRow, blurRow.Data() + (radius + 1), width - wsize, wsize, wsize * wsize);
+            }
 
-    for (int iy = 0; iy < HEIGHT; ++iy)
-        for (int ix = 0; ix < WIDTH; ++ix)
-            outputImage[iy * WIDTH + ix] = Clipping(inputImage[iy * WIDTH + ix] + lambda * (inputImage[iy * WIDTH + ix] - blurImage[iy * WIDTH + ix]));
+            for (int ix = 0; ix < width; ++ix)
+                outputRow[ix] = ClipSample<byte_t>(inputRow[ix] + lambda * (inputRow[ix] - blurRow[ix]));
+        }
+    }, 4 * wsize);
 
     return outputImage;
 }
 
-// +------------------------------------------------< MAIN >------------------------------------------------+
-
-int main(void)
+template <typename Pixel>
+ImageBuffer<Pixel>& GaussianUnsharpMasking(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const float sigma, const float lambda)
 {
-    static const char* INPUT_RAW_FILE_NAME  = "Pentagon.raw";
-    static const char* OUTPUT_RAW_FILE_NAME = "Pentagon_UnsharpMasking.raw";
-
-    FILE* fileStream;
+    TraceScope trace("GaussianUnsharpMasking", inputImage, outputImage);
 
-    fileStream = fopen(INPUT_RAW_FILE_NAME, "rb");
-    fread(inputImage, sizeof(inputImage), 1, fileStream);
-    fclose(fileStream);
+    assert(&inputImage != &outputImage);
 
-    CreateIntegralImage(inputImage, integralImage);
-    IntegralAveragingBlur(inputImage, integralImage, integralSpatialAveragingImage, 5);
-    UnsharpMasking(inputImage, integralSpatialAveragingImage, outputImage, 3.0F);
+    ScratchImage<Pixel> blurImage(inputImage.Width(), inputImage.Height());
 
-    fileStream = fopen(OUTPUT_RAW_FILE_NAME, "w+b");
-    fwrite(outputImage, sizeof(outputImage), 1, fileStream);
-    fclose(fileStream);
+    GaussianBlur(inputImage, blurImage, sigma);
 
-    return 0;
+    return UnsharpMasking(inputImage, blurImage, outputImage, lambda);
 }
 
+template Image&     GaussianUnsharpMasking(const Image&, Image&, const float, const float);
+template WideImage& GaussianUnsharpMasking(const WideImage&, WideImage&, const float, const float);
+template RGBImage&  GaussianUnsharpMasking(const RGBImage&, RGBImage&, const float, const float);
+template RGBAImage& GaussianUnsharpMasking(const RGBAImage&, RGBAImage&, const float, const float);
+
 // +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file
@@ -0,0 +1,26 @@
+// +-------------------------------------------< PREPROCESSING >--------------------------------------------+
+
+#ifndef UNSHARP_MASKING_H
+#define UNSHARP_MASKING_H
+
+// +----------------------------------------------< INCLUDE >-----------------------------------------------+
+
+#include "Image.h"
+
+// +------------------------------------------< UNSHARP MASKING >-------------------------------------------+
+
+template <typename Pixel>
+ImageBuffer<Pixel>& UnsharpMasking(const ImageBuffer<Pixel>& inputImage, const ImageBuffer<Pixel>& blurImage, ImageBuffer<Pixel>& outputImage, const float lambda = 0.3F);
+
+// Same result as CreateIntegralImage, IntegralAveragingBlur and UnsharpMasking in a row, fused into one pass over the input.
+// Keeps one running column sum per pixel of a row instead of the 4-byte integral and 1-byte blurred images per pixel. wsize is at
+// most 4103, so a box sum fits the 32-bit integral rows.
+Image& StreamingUnsharpMasking(const Image& inputImage, Image& outputImage, const int wsize, const float lambda = 0.3F);
+
+// UnsharpMasking with GaussianBlur as the blur stage, which avoids the ringing of the box blur at the same cost for any sigma
+template <typename Pixel>
+ImageBuffer<Pixel>& GaussianUnsharpMasking(const ImageBuffer<Pixel>& inputImage, ImageBuffer<Pixel>& outputImage, const float sigma, const float lambda = 0.3F);
+
+#endif
+
+// +------------------------------------------------< END >-------------------------------------------------+
\ No newline at end of file